@@ -14,111 +14,199 @@
 #include <vector>
 #include <thread>
 #include <iostream>
+#include <span>
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
 
 #include "../include/MatchingEngine.h"
 #include "../include/Configuration.h"
 #include "../include/Reporting.h"
 #include "../include/TickerResult.h"
+#include "../include/InstructionParser.h"
+#include "../include/InstructionFile.h"
+#include "../include/PerfCounters.h"
+#include "../include/SpscRing.h"
+#include "../include/Tsc.h"
 
 std::vector<TickerResult> latest_results;
+// Instructions per processBatch call in the replays, set with --batch_size.
+static size_t replay_batch_size = Config::instructionBatchSize;
 
-// Custom fast parser for positive integers
-inline const char* fast_atoi(const char* p, uint32_t& out) {
-    out = 0;
-    while (*p >= '0' && *p <= '9') {
-        out = out * 10 + (*p++ - '0');
+// Maps a whole file read-only. Returns nullptr for a missing or empty file.
+static const char* map_file(const std::string& filename, size_t& file_size) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1) return nullptr;
+
+    struct stat sb;
+    if (fstat(fd, &sb) == -1 || sb.st_size == 0) {
+        close(fd);
+        return nullptr;
     }
-    return p;
+    file_size = sb.st_size;
+
+    void* mapped_file = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    return (mapped_file == MAP_FAILED) ? nullptr : static_cast<const char*>(mapped_file);
 }
 
-// Custom fast parser for doubles
-inline const char* fast_atof(const char* p, double& out) {
-    double res = 0.0;
-    double frac = 0.0;
-    double div = 1.0;
-    while (*p >= '0' && *p <= '9') {
-        res = res * 10.0 + (*p++ - '0');
-    }
-    if (*p == '.') {
-        p++;
-        while (*p >= '0' && *p <= '9') {
-            frac = frac * 10.0 + (*p++ - '0');
-            div *= 10.0;
+// Runs the batch one instruction at a time, recording each one's TSC ticks
+// in the histogram of its type.
+static void time_batch(MatchingEngine& engine, std::span<const Instruction> batch, InstructionResult* results, TickerResult& result) {
+    if (result.latency.empty()) result.latency.resize(LatencyKindCount);
+    for (size_t i = 0; i < batch.size(); ++i) {
+        const uint64_t start = readTsc();
+        engine.processBatch(batch.subspan(i, 1), std::span<InstructionResult>(results + i, 1));
+        const uint64_t end = readTsc();
+        LatencyKind kind = AddRestLatency;
+        switch (batch[i].action) {
+        case InstructionAction::Add:
+            kind = (results[i].summary.fills > 0) ? AddMatchLatency : AddRestLatency;
+            break;
+        case InstructionAction::Cancel:
+            kind = CancelLatency;
+            break;
+        case InstructionAction::Edit:
+            kind = EditLatency;
+            break;
         }
-        res += frac / div;
+        result.latency[kind].record(end - start);
     }
-    out = res;
-    return p;
 }
 
-void process_ticker_file(MatchingEngine& engine, uint32_t tickerId, const std::string& filename, TickerResult& result) {
-    int fd = open(filename.c_str(), O_RDONLY);
-    if (fd == -1) return;
-
-    struct stat sb;
-    if (fstat(fd, &sb) == -1) {
-        close(fd);
-        return;
+// Runs one batch and adds it to the ticker's counts.
+static void run_batch(MatchingEngine& engine, std::span<const Instruction> batch, TickerResult& result) {
+    InstructionResult results[Config::maxInstructionBatchSize];
+    if constexpr (Config::recordLatencyHistograms) {
+        time_batch(engine, batch, results, result);
+    } else {
+        engine.processBatch(batch, results);
     }
-    size_t file_size = sb.st_size;
-
-    if (file_size == 0) {
-        close(fd);
-        return;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        switch (batch[i].action) {
+        case InstructionAction::Add:
+            result.add_count++;
+            break;
+        case InstructionAction::Cancel:
+            result.cancel_count++;
+            if (!results[i].accepted) result.failed_cancels++;
+            break;
+        case InstructionAction::Edit:
+            result.edit_count++;
+            if (!results[i].accepted) result.failed_edits++;
+            break;
+        }
     }
+    result.instruction_count += batch.size();
+}
 
-    const char* mapped_file = static_cast<const char*>(mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0));
-    if (mapped_file == MAP_FAILED) {
-        close(fd);
-        return;
-    }
-    close(fd);
+// Text replay, parsing and matching on the calling thread: the vectorised
+// parser fills batches of batch_size instructions and each goes to the
+// engine whole, so it can prefetch ahead.
+void process_ticker_file(MatchingEngine& engine, uint32_t tickerId, const std::string& filename, size_t batch_size, TickerResult& result) {
+    size_t file_size = 0;
+    const char* mapped_file = map_file(filename, file_size);
+    if (mapped_file == nullptr) return;
 
     const char* p = mapped_file;
     const char* end = mapped_file + file_size;
 
     auto start_time = std::chrono::high_resolution_clock::now();
 
+    Instruction batch[Config::maxInstructionBatchSize];
     while (p < end) {
-        uint32_t id, qty;
-        double price;
-        char type, side_char;
-
-        p = fast_atoi(p, id);
-        p++; // Skip ';'
+        size_t skipped = 0; // Unknown instruction types
+        size_t n = parseInstructions(p, end, static_cast<uint16_t>(tickerId), batch, batch_size, skipped);
+        result.instruction_count += skipped;
+        run_batch(engine, std::span<const Instruction>(batch, n), result);
+    }
 
-        while (*p != ';') p++; // Skip ticker
-        p++; // Skip ';'
+    auto end_time = std::chrono::high_resolution_clock::now();
+    result.time_ms = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count() / 1000.0;
 
-        side_char = *p;
-        p += 2; // Skip side and ';'
+    munmap((void*)mapped_file, file_size);
+}
 
-        p = fast_atof(p, price);
-        p++; // Skip ';'
+// A batch of decoded instructions in flight from the parser thread.
+struct ParsedBatch {
+    Instruction records[Config::maxInstructionBatchSize];
+    uint32_t count;
+    uint32_t skipped;
+    bool last;
+};
 
-        p = fast_atoi(p, qty);
-        p++; // Skip ';'
+// Text replay on two threads: a parser thread decodes batches straight into
+// the slots of an SPSC ring and the calling thread only matches them. Pays
+// off when there is a spare core per ticker for the parser.
+void process_ticker_file_pipelined(MatchingEngine& engine, uint32_t tickerId, const std::string& filename, size_t batch_size, TickerResult& result) {
+    size_t file_size = 0;
+    const char* mapped_file = map_file(filename, file_size);
+    if (mapped_file == nullptr) return;
+    madvise((void*)mapped_file, file_size, MADV_SEQUENTIAL);
 
-        type = *p;
-        
-        while (p < end && *p != '\n') p++;
-        p++; // Skip newline
+    auto start_time = std::chrono::high_resolution_clock::now();
 
-        if (type == 'A') {
-            result.add_count++;
-            engine.processOrders(tickerId, side_char == 'B', price, qty, 0, id);
-        } else if (type == 'C') {
-            result.cancel_count++;
-            if (!engine.cancelOrder(tickerId, id)) {
-                result.failed_cancels++;
-            }
-        } else if (type == 'E') {
-            result.edit_count++;
-            if (!engine.editOrder(tickerId, id, price, qty)) {
-                result.failed_edits++;
-            }
+    SpscRing<ParsedBatch> ring(Config::parserRingBatches);
+    std::thread parser([&ring, mapped_file, file_size, tickerId, batch_size]() {
+        const char* p = mapped_file;
+        const char* end = mapped_file + file_size;
+        bool last = false;
+        while (!last) {
+            ParsedBatch* batch;
+            while ((batch = ring.claim()) == nullptr) std::this_thread::yield();
+            size_t skipped = 0;
+            batch->count = static_cast<uint32_t>(parseInstructions(p, end, static_cast<uint16_t>(tickerId), batch->records, batch_size, skipped));
+            batch->skipped = static_cast<uint32_t>(skipped);
+            batch->last = last = (p >= end);
+            ring.publish();
         }
-        result.instruction_count++;
+    });
+
+    bool last = false;
+    while (!last) {
+        const ParsedBatch* batch;
+        while ((batch = ring.front()) == nullptr) std::this_thread::yield();
+        result.instruction_count += batch->skipped;
+        run_batch(engine, std::span<const Instruction>(batch->records, batch->count), result);
+        last = batch->last;
+        ring.release();
+    }
+    parser.join();
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    result.time_ms = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count() / 1000.0;
+
+    munmap((void*)mapped_file, file_size);
+}
+
+// Binary replay: records go to the engine straight from the mapping, with no
+// decoding at all. A file holds one ticker's records; files written for
+// another ticker or record layout are skipped.
+void process_ticker_binary(MatchingEngine& engine, uint32_t tickerId, const std::string& filename, size_t batch_size, TickerResult& result) {
+    size_t file_size = 0;
+    const char* mapped_file = map_file(filename, file_size);
+    if (mapped_file == nullptr) return;
+
+    InstructionFileHeader header;
+    std::memcpy(&header, mapped_file, std::min(file_size, sizeof(header)));
+    if (file_size < sizeof(header) || !isValidInstructionFile(header, file_size)) {
+        std::cerr << "Skipping " << filename << ": not a compatible binary instruction file" << std::endl;
+        munmap((void*)mapped_file, file_size);
+        return;
+    }
+    const Instruction* records = reinterpret_cast<const Instruction*>(mapped_file + sizeof(header));
+    if (header.recordCount > 0 && records[0].tickerId != tickerId) {
+        std::cerr << "Skipping " << filename << ": records belong to ticker " << records[0].tickerId << std::endl;
+        munmap((void*)mapped_file, file_size);
+        return;
+    }
+    madvise((void*)mapped_file, file_size, MADV_SEQUENTIAL);
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    for (uint64_t i = 0; i < header.recordCount; i += batch_size) {
+        size_t n = std::min<uint64_t>(batch_size, header.recordCount - i);
+        run_batch(engine, std::span<const Instruction>(records + i, n), result);
     }
 
     auto end_time = std::chrono::high_resolution_clock::now();
@@ -127,7 +215,15 @@ void process_ticker_file(MatchingEngine& engine, uint32_t tickerId, const std::s
     munmap((void*)mapped_file, file_size);
 }
 
-static void BM_OrderProcessing(benchmark::State& state) {
+using TickerFileProcessor = void (*)(MatchingEngine&, uint32_t, const std::string&, size_t, TickerResult&);
+
+// Replays every ticker's file on its own thread. All variants run the same
+// instructions: binary against text is the cost of parsing, and
+// text_pipelined against text how much of it a parser thread takes off
+// matching. Hardware counters of each replay thread, where the kernel offers
+// them, become user counters (per iteration) and columns of print_table.
+static void BM_OrderProcessing(benchmark::State& state, TickerFileProcessor process, const std::string& extension) {
+    PerfCounts perf_total; // Summed over replay threads and iterations
     for (auto _ : state) {
         MatchingEngine engine;
         for (uint32_t i = 0; i < Config::tickers.size(); ++i) {
@@ -139,8 +235,13 @@ static void BM_OrderProcessing(benchmark::State& state) {
 
         for (uint32_t i = 0; i < Config::tickers.size(); ++i) {
             results[i].name = Config::tickers[i];
-            std::string filename = Config::tickers[i] + ".dat";
-            threads.emplace_back(process_ticker_file, std::ref(engine), i, filename, std::ref(results[i]));
+            std::string filename = Config::tickers[i] + extension;
+            threads.emplace_back([&engine, &result = results[i], process, i, filename]() {
+                PerfCounters counters; // Of this replay thread only, not of a parser it starts
+                counters.start();
+                process(engine, i, filename, replay_batch_size, result);
+                result.perf = counters.stop();
+            });
         }
 
         for (auto& t : threads) {
@@ -148,15 +249,47 @@ static void BM_OrderProcessing(benchmark::State& state) {
         }
 
         long long total_instructions = 0;
-        for(const auto& r : results) total_instructions += r.instruction_count;
+        for(const auto& r : results) {
+            total_instructions += r.instruction_count;
+            perf_total.merge(r.perf);
+        }
         state.SetItemsProcessed(total_instructions);
         latest_results = std::move(results);
     }
+
+    for (size_t event = 0; event < PerfEventCount; ++event) {
+        if (!perf_total.valid[event]) continue;
+        state.counters[PerfCounters::name(static_cast<PerfEvent>(event))] =
+            benchmark::Counter(static_cast<double>(perf_total.values[event]), benchmark::Counter::kAvgIterations);
+    }
 }
 
-BENCHMARK(BM_OrderProcessing)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_OrderProcessing, text, process_ticker_file, Config::textDataExtension)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_OrderProcessing, text_pipelined, process_ticker_file_pipelined, Config::textDataExtension)->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_OrderProcessing, binary, process_ticker_binary, Config::binaryDataExtension)->Unit(benchmark::kMillisecond);
+
+// Takes --batch_size=N, the replays' processBatch depth, out of argv.
+static bool parse_batch_size(int& argc, char** argv) {
+    const std::string flag = "--batch_size=";
+    int kept = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], flag.c_str(), flag.size()) != 0) {
+            argv[kept++] = argv[i];
+            continue;
+        }
+        const long long value = std::atoll(argv[i] + flag.size());
+        if (value < 1 || static_cast<size_t>(value) > Config::maxInstructionBatchSize) {
+            std::cerr << "--batch_size must be between 1 and " << Config::maxInstructionBatchSize << std::endl;
+            return false;
+        }
+        replay_batch_size = static_cast<size_t>(value);
+    }
+    argc = kept;
+    return true;
+}
 
 int main(int argc, char** argv) {
+    if (!parse_batch_size(argc, argv)) return 1;
     benchmark::Initialize(&argc, argv);
     if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
     benchmark::RunSpecifiedBenchmarks();
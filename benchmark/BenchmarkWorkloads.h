@@ -0,0 +1,45 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef BENCHMARK_WORKLOADS_INCLUDED
+#define BENCHMARK_WORKLOADS_INCLUDED
+
+#include <cstddef>
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include "../include/Instruction.h"
+#include "../include/WorkloadGenerator.h"
+
+// Size of the generated workloads the benchmarks replay.
+constexpr size_t benchmarkTickers = 10;
+constexpr size_t benchmarkInstructions = size_t{1} << 20;
+
+// Workloads are generated once per model and reused by every run of every
+// benchmark, so only matching is measured; the fixed seed keeps them
+// identical across runs. Models are told apart by the fields the benchmarks
+// vary: tickerCount, tickerZipfExponent and marketableRatio.
+inline const std::vector<Instruction>& modelledWorkload(const WorkloadModel& model,
+                                                        size_t instructions = benchmarkInstructions) {
+    static std::map<std::tuple<size_t, double, double, size_t>, std::vector<Instruction>> cache;
+    auto& workload = cache[{model.tickerCount, model.tickerZipfExponent, model.marketableRatio, instructions}];
+    if (workload.empty()) {
+        workload = WorkloadGenerator::generate(model, instructions);
+    }
+    return workload;
+}
+
+// The default model over tickers books.
+inline const std::vector<Instruction>& defaultWorkload(size_t tickers = benchmarkTickers,
+                                                       size_t instructions = benchmarkInstructions) {
+    WorkloadModel model;
+    model.tickerCount = tickers;
+    return modelledWorkload(model, instructions);
+}
+
+#endif // !BENCHMARK_WORKLOADS_INCLUDED
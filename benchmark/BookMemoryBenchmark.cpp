@@ -0,0 +1,78 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unistd.h>
+
+#include "../include/MatchingEngine.h"
+
+// Resident set size of the process, from /proc/self/statm.
+static size_t residentBytes() {
+    size_t pages = 0, resident = 0;
+    if (FILE* statm = std::fopen("/proc/self/statm", "r")) {
+        if (std::fscanf(statm, "%zu %zu", &pages, &resident) != 2) resident = 0;
+        std::fclose(statm);
+    }
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+// Memory per book of a large symbol universe. range(0) tickers are registered
+// on an empty engine (idle), then each gets range(1) resting orders on either
+// side (active), then everything is cancelled and the books shrunk (drained).
+// The *_rss counters are the growth in process RSS per book at each stage;
+// *_bytes are what the books account for themselves (OrderBook::memoryUsage,
+// including the report ring, which is reserved but not resident).
+static void BM_BookFootprint(benchmark::State& state) {
+    const uint32_t books = static_cast<uint32_t>(state.range(0));
+    const uint32_t ordersPerBook = static_cast<uint32_t>(state.range(1));
+
+    for (auto _ : state) {
+        const size_t baseline = residentBytes();
+        auto engine = std::make_unique<MatchingEngine>(0);
+        for (uint32_t t = 0; t < books; ++t) {
+            engine->addTicker("SYM" + std::to_string(t));
+        }
+        const size_t idle = residentBytes();
+        const size_t idleBytes = engine->bookMemoryUsage(0);
+
+        uint32_t id = 1;
+        for (uint32_t t = 0; t < books; ++t) {
+            for (uint32_t i = 0; i < ordersPerBook; ++i) {
+                const bool isBuy = i & 1;
+                engine->processOrders(t, isBuy, isBuy ? 1000u - i : 1001u + i, 10u, 0u, id++);
+            }
+        }
+        const size_t active = residentBytes();
+        const size_t activeBytes = engine->bookMemoryUsage(0);
+
+        id = 1;
+        for (uint32_t t = 0; t < books; ++t) {
+            for (uint32_t i = 0; i < ordersPerBook; ++i) {
+                engine->cancelOrder(t, id++);
+            }
+        }
+        engine->shrinkToFit();
+        const size_t drained = residentBytes();
+
+        state.counters["idle_rss"] = static_cast<double>(idle - baseline) / books;
+        state.counters["active_rss"] = static_cast<double>(active - baseline) / books;
+        state.counters["drained_rss"] = static_cast<double>(drained - baseline) / books;
+        state.counters["idle_bytes"] = static_cast<double>(idleBytes);
+        state.counters["active_bytes"] = static_cast<double>(activeBytes);
+        state.counters["drained_bytes"] = static_cast<double>(engine->bookMemoryUsage(0));
+        state.counters["arena_bytes"] = static_cast<double>(engine->slabArena().residentBytes());
+    }
+}
+
+BENCHMARK(BM_BookFootprint)
+    ->Args({8192, 64})
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,237 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../include/OrderBook.h"
+#include "../include/Tsc.h"
+
+// One OrderBook operation per benchmark, on synthetic books built in memory.
+// Each iteration times only the operation under test with the TSC and reports
+// it as manual time; whatever puts the book back in its starting shape runs
+// outside the measurement, so every iteration sees the same book.
+
+// Synthetic books are built around this tick: bids at and below midTick - 1,
+// asks at and above midTick + 1.
+constexpr uint32_t midTick = 1 << 20;
+constexpr uint32_t restingQuantity = 10;
+
+static uint32_t bidPrice(size_t level, uint32_t spacing) {
+    return midTick - 1 - static_cast<uint32_t>(level) * spacing;
+}
+
+static uint32_t askPrice(size_t level, uint32_t spacing) {
+    return midTick + 1 + static_cast<uint32_t>(level) * spacing;
+}
+
+// levels bid and ask levels of perLevel orders each, spacing ticks apart on
+// each side. IDs from nextId up are handed out level by level, best first,
+// bids before asks.
+static std::unique_ptr<OrderBook> buildBook(size_t levels, size_t perLevel, uint32_t spacing, uint32_t& nextId) {
+    auto book = std::make_unique<OrderBook>();
+    book->reserve(2 * levels * perLevel);
+    for (size_t level = 0; level < levels; ++level) {
+        for (size_t i = 0; i < perLevel; ++i) {
+            book->processOrders(true, bidPrice(level, spacing), restingQuantity, 0, nextId++);
+        }
+    }
+    for (size_t level = 0; level < levels; ++level) {
+        for (size_t i = 0; i < perLevel; ++i) {
+            book->processOrders(false, askPrice(level, spacing), restingQuantity, 0, nextId++);
+        }
+    }
+    return book;
+}
+
+// Runs op between two TSC reads and makes that the iteration's time.
+template <typename Op>
+static void timeOperation(benchmark::State& state, double nanosPerTick, Op&& op) {
+    const uint64_t start = readTsc();
+    op();
+    const uint64_t end = readTsc();
+    state.SetIterationTime(static_cast<double>(end - start) * nanosPerTick * 1e-9);
+}
+
+static void drainReports(OrderBook& book) {
+    ExecutionReport batch[256];
+    while (book.executionReports().popBatch(batch, 256) > 0) {
+    }
+}
+
+// A bid that does not cross, spread over the bid levels in turn, then
+// cancelled untimed. range(0) levels of range(1) orders per side; range(2) is
+// the spacing: 1 is a dense book where the bid joins the back of an existing
+// queue, 16 a sparse one where it lands in a gap and opens a level of its own.
+static void BM_PassiveAdd(benchmark::State& state) {
+    const size_t levels = state.range(0);
+    const size_t perLevel = state.range(1);
+    const uint32_t spacing = static_cast<uint32_t>(state.range(2));
+    uint32_t id = 1;
+    auto book = buildBook(levels, perLevel, spacing, id);
+
+    const double nanosPerTick = tscNanosPerTick();
+    const uint32_t gapOffset = spacing / 2; // 0 in a dense book
+    size_t level = 0;
+    for (auto _ : state) {
+        const uint32_t price = bidPrice(level, spacing) - gapOffset;
+        timeOperation(state, nanosPerTick, [&] {
+            benchmark::DoNotOptimize(book->processOrders(true, price, restingQuantity, 0, id));
+        });
+        book->cancelOrder(id);
+        if (++level == levels) level = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_PassiveAdd)
+    ->ArgsProduct({{10, 1000}, {1, 100}, {1, 16}})
+    ->UseManualTime();
+
+// A buy that takes everything on the best range(0) ask levels of range(1)
+// orders each, out of a book 128 levels deep. The taken asks are put back and
+// the execution reports drained untimed, so every sweep emits its reports
+// into an empty ring.
+static void BM_SweepAdd(benchmark::State& state) {
+    const size_t swept = state.range(0);
+    const size_t perLevel = state.range(1);
+    uint32_t id = 1;
+    auto book = buildBook(128, perLevel, 1, id);
+    drainReports(*book);
+
+    const double nanosPerTick = tscNanosPerTick();
+    const uint32_t quantity = static_cast<uint32_t>(swept * perLevel) * restingQuantity;
+    const uint32_t limit = askPrice(swept - 1, 1);
+    for (auto _ : state) {
+        const uint32_t aggressor = id++;
+        timeOperation(state, nanosPerTick, [&] {
+            benchmark::DoNotOptimize(book->processOrders(true, limit, quantity, 0, aggressor));
+        });
+        for (size_t level = 0; level < swept; ++level) {
+            for (size_t i = 0; i < perLevel; ++i) {
+                book->processOrders(false, askPrice(level, 1), restingQuantity, 0, id++);
+            }
+        }
+        drainReports(*book);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["fills"] = static_cast<double>(swept * perLevel);
+}
+
+BENCHMARK(BM_SweepAdd)
+    ->ArgsProduct({{1, 10, 100}, {1, 10, 100}})
+    ->UseManualTime();
+
+// Cancels the order at the head (range(0) = 0), the middle (1) or the tail (2)
+// of the best bid's queue of range(1) orders, in a book 10 levels deep. The
+// order goes back in untimed, at the tail, and the next iteration cancels
+// whichever order is then at the same position.
+static void BM_CancelInQueue(benchmark::State& state) {
+    const int position = static_cast<int>(state.range(0));
+    const size_t perLevel = state.range(1);
+    uint32_t id = 1;
+    auto book = buildBook(10, perLevel, 1, id);
+
+    std::vector<uint32_t> queue(perLevel); // IDs at the best bid, front first
+    for (size_t i = 0; i < perLevel; ++i) {
+        queue[i] = static_cast<uint32_t>(i + 1);
+    }
+    const size_t at = (position == 0) ? 0 : (position == 1) ? perLevel / 2 : perLevel - 1;
+
+    const double nanosPerTick = tscNanosPerTick();
+    for (auto _ : state) {
+        const uint32_t victim = queue[at];
+        timeOperation(state, nanosPerTick, [&] {
+            benchmark::DoNotOptimize(book->cancelOrder(victim));
+        });
+        book->processOrders(true, bidPrice(0, 1), restingQuantity, 0, victim);
+        queue.erase(queue.begin() + at);
+        queue.push_back(victim);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_CancelInQueue)
+    ->ArgsProduct({{0, 1, 2}, {10, 1000}})
+    ->UseManualTime();
+
+// Cancels the only order at the best bid, so the book has to find the next
+// best level range(1) ticks further down, among range(0) bid levels of 10
+// orders each. The order is put back untimed.
+static void BM_CancelBestLevel(benchmark::State& state) {
+    const size_t levels = state.range(0);
+    const uint32_t spacing = static_cast<uint32_t>(state.range(1));
+    uint32_t id = 1;
+    auto book = buildBook(levels + 1, 10, spacing, id);
+    for (uint32_t queued = 1; queued <= 10; ++queued) { // Empty the best level
+        book->cancelOrder(queued);
+    }
+
+    const uint32_t best = bidPrice(0, spacing);
+    const uint32_t top = id++;
+    book->processOrders(true, best, restingQuantity, 0, top);
+
+    const double nanosPerTick = tscNanosPerTick();
+    for (auto _ : state) {
+        timeOperation(state, nanosPerTick, [&] {
+            benchmark::DoNotOptimize(book->cancelOrder(top));
+        });
+        book->processOrders(true, best, restingQuantity, 0, top);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_CancelBestLevel)
+    ->ArgsProduct({{10, 1000}, {1, 16, 256}})
+    ->UseManualTime();
+
+// Amends of one bid in a book of range(1) levels of range(2) orders per side.
+// range(0) picks the amend:
+//   0 - quantity down at the same price, which keeps priority
+//   1 - price change between the two best bid levels, to the back of a queue
+//       of range(2) orders; never marketable
+static void BM_AmendOrder(benchmark::State& state) {
+    const int kind = static_cast<int>(state.range(0));
+    const size_t levels = state.range(1);
+    const size_t perLevel = state.range(2);
+    uint32_t id = 1;
+    auto book = buildBook(levels, perLevel, 1, id);
+
+    constexpr uint32_t fullQuantity = 1'000'000;
+    const uint32_t target = id++;
+    book->processOrders(true, bidPrice(0, 1), fullQuantity, 0, target);
+
+    const double nanosPerTick = tscNanosPerTick();
+    uint32_t quantity = fullQuantity;
+    bool atBest = true;
+    for (auto _ : state) {
+        if (kind == 0) {
+            if (quantity == 1) { // Top the order up again, untimed
+                book->cancelOrder(target);
+                book->processOrders(true, bidPrice(0, 1), fullQuantity, 0, target);
+                quantity = fullQuantity;
+            }
+            const uint32_t newQuantity = --quantity;
+            timeOperation(state, nanosPerTick, [&] {
+                benchmark::DoNotOptimize(book->editOrder(target, bidPrice(0, 1), newQuantity));
+            });
+        } else {
+            const uint32_t price = bidPrice(atBest ? 1 : 0, 1);
+            timeOperation(state, nanosPerTick, [&] {
+                benchmark::DoNotOptimize(book->editOrder(target, price, quantity));
+            });
+            atBest = !atBest;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_AmendOrder)
+    ->ArgsProduct({{0, 1}, {10, 1000}, {1, 100}})
+    ->UseManualTime();
@@ -0,0 +1,163 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "../include/BookScheduler.h"
+#include "../include/Configuration.h"
+#include "../include/MatchingEngine.h"
+
+namespace {
+
+constexpr size_t replayInstructions = size_t{1} << 19;
+// Activity of the k-th busiest instrument falls off as 1 / k^zipfExponent.
+constexpr double zipfExponent = 1.1;
+
+// A replay across books instruments, each drawn from a Zipf distribution:
+// adds, and cancels of one of the ticker's recent adds.
+struct ZipfReplay {
+    std::vector<Instruction> instructions;
+    std::vector<std::vector<Instruction>> perTicker;
+};
+
+const ZipfReplay& zipfReplay(size_t books) {
+    static std::map<size_t, std::unique_ptr<ZipfReplay>> cache;
+    auto& replay = cache[books];
+    if (replay) return *replay;
+    replay = std::make_unique<ZipfReplay>();
+
+    std::vector<double> cdf(books);
+    double sum = 0.0;
+    for (size_t k = 0; k < books; ++k) {
+        sum += 1.0 / std::pow(static_cast<double>(k + 1), zipfExponent);
+        cdf[k] = sum;
+    }
+
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> uniform(0.0, sum);
+    std::vector<std::vector<uint32_t>> recentAdds(books);
+    replay->instructions.reserve(replayInstructions);
+    replay->perTicker.resize(books);
+    uint32_t nextId = Config::initialOrderId;
+
+    for (size_t i = 0; i < replayInstructions; ++i) {
+        const size_t ticker = std::min<size_t>(std::lower_bound(cdf.begin(), cdf.end(), uniform(rng)) - cdf.begin(), books - 1);
+        const uint64_t bits = rng();
+        auto& recent = recentAdds[ticker];
+
+        Instruction instruction{};
+        instruction.tickerId = static_cast<uint16_t>(ticker);
+        instruction.timestamp = i;
+        if (recent.size() > 16 && (bits & 3) == 0) {
+            instruction.ID = recent[recent.size() - 1 - (bits >> 8) % 16];
+            instruction.action = InstructionAction::Cancel;
+        } else {
+            instruction.ID = nextId++;
+            instruction.price = 1000 + (bits >> 16) % 64;
+            instruction.quantity = 10 + (bits >> 32) % 90;
+            instruction.flags = Instruction::makeFlags((bits >> 2) & 1);
+            recent.push_back(instruction.ID);
+        }
+        replay->instructions.push_back(instruction);
+        replay->perTicker[ticker].push_back(instruction);
+    }
+    return *replay;
+}
+
+} // namespace
+
+// The existing replay model: one thread per instrument, each matching its own
+// instructions. range(0) instruments.
+static void BM_ThreadPerTicker(benchmark::State& state) {
+    const size_t books = static_cast<size_t>(state.range(0));
+    const ZipfReplay& replay = zipfReplay(books);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto engine = std::make_unique<MatchingEngine>(books);
+        state.ResumeTiming();
+
+        std::vector<std::thread> threads;
+        threads.reserve(books);
+        for (size_t t = 0; t < books; ++t) {
+            threads.emplace_back([&, t]() {
+                const std::vector<Instruction>& mine = replay.perTicker[t];
+                InstructionResult results[Config::instructionBatchSize];
+                for (size_t i = 0; i < mine.size(); i += Config::instructionBatchSize) {
+                    const size_t n = std::min(Config::instructionBatchSize, mine.size() - i);
+                    engine->processBatch(std::span<const Instruction>(mine.data() + i, n), std::span<InstructionResult>(results, n));
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+
+        state.PauseTiming();
+        engine.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * replay.instructions.size());
+}
+
+// The same replay submitted in order from one thread to a BookScheduler with
+// range(1) workers (0 for one per hardware thread). range(0) instruments.
+static void BM_BookScheduler(benchmark::State& state) {
+    const size_t books = static_cast<size_t>(state.range(0));
+    const ZipfReplay& replay = zipfReplay(books);
+
+    BookScheduler::WorkerStats total;
+    uint64_t rejected = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto engine = std::make_unique<MatchingEngine>(books);
+        auto scheduler = std::make_unique<BookScheduler>(*engine, static_cast<size_t>(state.range(1)));
+        state.ResumeTiming();
+
+        scheduler->start();
+        for (const Instruction& instruction : replay.instructions) {
+            while (!scheduler->submit(instruction)) {
+                std::this_thread::yield();
+            }
+        }
+        scheduler->stop();
+
+        state.PauseTiming();
+        for (size_t w = 0; w < scheduler->workerCount(); ++w) {
+            BookScheduler::WorkerStats stats = scheduler->stats(w);
+            total.processed += stats.processed;
+            total.bookRuns += stats.bookRuns;
+            total.steals += stats.steals;
+        }
+        rejected += scheduler->rejectedSubmits();
+        scheduler.reset();
+        engine.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(total.processed);
+    state.counters["per_run"] = total.bookRuns ? static_cast<double>(total.processed) / total.bookRuns : 0.0;
+    state.counters["steals"] = benchmark::Counter(static_cast<double>(total.steals), benchmark::Counter::kAvgIterations);
+    state.counters["rejected"] = benchmark::Counter(static_cast<double>(rejected), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_ThreadPerTicker)
+    ->Arg(64)->Arg(1024)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_BookScheduler)
+    ->ArgsProduct({{64, 1024}, {0, 2, 4}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,112 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+#include "../include/FastMap.h"
+
+// Steady-state add/cancel churn: range(0) live IDs, every iteration cancels
+// the oldest, adds a new one and looks up a live one. A map that accumulates
+// tombstones slows down the longer this runs; this one must not.
+static void BM_FastMapChurn(benchmark::State& state) {
+    const uint32_t live = static_cast<uint32_t>(state.range(0));
+    FastMap map;
+    map.reserve(live);
+
+    uint32_t oldest = 1;
+    uint32_t next = 1;
+    for (; next <= live; ++next) {
+        map.insert(next, next);
+    }
+
+    uint32_t probe = 0x9e3779b9;
+    for (auto _ : state) {
+        map.erase(oldest++);
+        map.insert(next, next);
+        next++;
+        probe = probe * 1664525 + 1013904223;
+        benchmark::DoNotOptimize(map.find(oldest + probe % live));
+    }
+    state.SetItemsProcessed(state.iterations() * 3);
+    state.counters["size"] = map.size();
+    state.counters["capacity"] = map.capacity();
+}
+
+BENCHMARK(BM_FastMapChurn)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+// Same churn, but cancels hit random live IDs instead of the oldest one,
+// which scatters holes over the whole table.
+static void BM_FastMapRandomCancelChurn(benchmark::State& state) {
+    const uint32_t live = static_cast<uint32_t>(state.range(0));
+    FastMap map;
+    map.reserve(live);
+
+    std::vector<uint32_t> ids(live);
+    uint32_t next = 1;
+    for (auto& id : ids) {
+        id = next++;
+        map.insert(id, id);
+    }
+
+    uint32_t rng = 0x9e3779b9;
+    for (auto _ : state) {
+        rng = rng * 1664525 + 1013904223;
+        uint32_t& slot = ids[rng % live];
+        map.erase(slot);
+        slot = next++;
+        map.insert(slot, slot);
+        benchmark::DoNotOptimize(map.find(ids[(rng >> 8) % live]));
+    }
+    state.SetItemsProcessed(state.iterations() * 3);
+}
+
+BENCHMARK(BM_FastMapRandomCancelChurn)->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+
+// clear() keeps the table, so refilling a presized map never reallocates.
+static void BM_FastMapClearRefill(benchmark::State& state) {
+    const uint32_t n = static_cast<uint32_t>(state.range(0));
+    FastMap map;
+    map.reserve(n);
+
+    for (auto _ : state) {
+        for (uint32_t key = 1; key <= n; ++key) {
+            map.insert(key, key);
+        }
+        map.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_FastMapClearRefill)->Arg(1 << 10)->Arg(1 << 16);
+
+// Lookups of random IDs among range(0) live ones. range(1) is how many times
+// the minimum table size the map is reserved at, so the load factor is 1/2,
+// 1/4 or 1/8; range(2) = 0 looks up live IDs, 1 IDs that are not there, whose
+// probes run to the end of their chain.
+static void BM_FastMapLookup(benchmark::State& state) {
+    const uint32_t live = static_cast<uint32_t>(state.range(0));
+    const uint32_t slack = static_cast<uint32_t>(state.range(1));
+    const bool missing = state.range(2) != 0;
+    FastMap map;
+    map.reserve(static_cast<size_t>(live) * slack);
+    for (uint32_t key = 1; key <= live; ++key) {
+        map.insert(key, key);
+    }
+
+    const uint32_t first = missing ? live + 1 : 1;
+    uint32_t rng = 0x9e3779b9;
+    for (auto _ : state) {
+        rng = rng * 1664525 + 1013904223;
+        benchmark::DoNotOptimize(map.find(first + (rng >> 4) % live));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["load"] = static_cast<double>(map.size()) / map.capacity();
+}
+
+BENCHMARK(BM_FastMapLookup)->ArgsProduct({{1 << 10, 1 << 16, 1 << 20}, {1, 2, 4}, {0, 1}});
@@ -0,0 +1,73 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <vector>
+
+#include "../include/FastMap.h"
+#include "../include/DirectIdTable.h"
+
+// How the IDs of new orders are drawn.
+enum IdPattern {
+    Dense,  // Sequential, like GenerateData's id_counter
+    Sparse, // Increasing with a stride of 64, e.g. IDs shared by many tickers
+    Random  // Uniform over a window 8x the live set, ahead of a moving base
+};
+
+// Order ID index churn: range(0) live orders, every iteration adds an order,
+// looks up a random live one and cancels a random live one.
+template <class Index>
+static void BM_IdIndexChurn(benchmark::State& state) {
+    const uint32_t live = static_cast<uint32_t>(state.range(0));
+    const IdPattern pattern = static_cast<IdPattern>(state.range(1));
+    Index index;
+    index.reserve(live);
+
+    uint32_t rng = 0x9e3779b9;
+    uint32_t next = 1;
+    auto nextId = [&]() {
+        rng = rng * 1664525 + 1013904223;
+        switch (pattern) {
+        case Dense:
+            return next++;
+        case Sparse:
+            return next += 64;
+        default:
+            next++; // Base of the window moves one ID per order
+            return next + (rng >> 4) % (8 * live);
+        }
+    };
+
+    std::vector<uint32_t> ids(live);
+    for (auto& id : ids) {
+        do {
+            id = nextId();
+        } while (index.find(id));
+        index.insert(id, 0);
+    }
+
+    for (auto _ : state) {
+        uint32_t id;
+        do {
+            id = nextId();
+        } while (index.find(id));
+        rng = rng * 1664525 + 1013904223;
+        benchmark::DoNotOptimize(index.find(ids[(rng >> 8) % live]));
+        uint32_t& slot = ids[(rng >> 12) % live];
+        index.erase(slot);
+        slot = id;
+        index.insert(id, 0);
+    }
+    state.SetItemsProcessed(state.iterations() * 3);
+    state.counters["bytes"] = index.memoryUsage();
+}
+
+BENCHMARK_TEMPLATE(BM_IdIndexChurn, FastMap)
+    ->ArgsProduct({{1 << 10, 1 << 16}, {Dense, Sparse, Random}});
+BENCHMARK_TEMPLATE(BM_IdIndexChurn, DirectIdTable)
+    ->ArgsProduct({{1 << 10, 1 << 16}, {Dense, Sparse, Random}});
@@ -0,0 +1,84 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../include/Configuration.h"
+#include "../include/InputJournal.h"
+#include "../include/LatencyHistogram.h"
+#include "../include/MatchingEngine.h"
+#include "../include/Tsc.h"
+#include "BenchmarkWorkloads.h"
+
+// A shard worker's loop on one thread: each batch is appended to the journal,
+// then matched. range(0) is the journal mode: 0 off, 1 async, 2 group commit.
+// The final flush, making every record durable, is part of the time. p50_ns
+// and p99_ns are per batch of Config::instructionBatchSize instructions,
+// journal append included; overflows counts batches that found the
+// journal's ring full and went to its overflow buffer.
+static void BM_JournaledMatching(benchmark::State& state) {
+    const int mode = static_cast<int>(state.range(0));
+    const std::vector<Instruction>& workload = defaultWorkload();
+    const std::string path = (std::filesystem::temp_directory_path() / "orderbook_benchmark.journal").string();
+    const double nanosPerTick = tscNanosPerTick();
+
+    LatencyHistogram batchNs;
+    uint64_t overflows = 0;
+    uint64_t syncs = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::remove(path.c_str());
+        auto engine = std::make_unique<MatchingEngine>(benchmarkTickers);
+        std::unique_ptr<InputJournal> journal;
+        if (mode != 0) {
+            journal = std::make_unique<InputJournal>(path, mode == 1 ? JournalMode::Async : JournalMode::GroupCommit);
+            if (!journal->ok()) {
+                state.SkipWithError("Cannot create the journal");
+                break;
+            }
+        }
+        state.ResumeTiming();
+
+        InstructionResult results[Config::instructionBatchSize];
+        for (size_t i = 0; i < workload.size(); i += Config::instructionBatchSize) {
+            const size_t n = std::min(Config::instructionBatchSize, workload.size() - i);
+            const std::span<const Instruction> batch(workload.data() + i, n);
+            const uint64_t start = readTsc();
+            if (journal) journal->append(batch);
+            engine->processBatch(batch, std::span<InstructionResult>(results, n));
+            batchNs.record(static_cast<uint64_t>((readTsc() - start) * nanosPerTick));
+        }
+        if (journal) {
+            journal->flush();
+            syncs += journal->syncs();
+            overflows += journal->overflowedBatches();
+        }
+
+        state.PauseTiming();
+        journal.reset();
+        engine.reset();
+        state.ResumeTiming();
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations() * workload.size());
+    state.counters["p50_ns"] = static_cast<double>(batchNs.valueAtPercentile(50.0));
+    state.counters["p99_ns"] = static_cast<double>(batchNs.valueAtPercentile(99.0));
+    state.counters["overflows"] = benchmark::Counter(static_cast<double>(overflows), benchmark::Counter::kAvgIterations);
+    state.counters["syncs"] = benchmark::Counter(static_cast<double>(syncs), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_JournaledMatching)
+    ->DenseRange(0, 2)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,155 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "../include/Configuration.h"
+#include "../include/L2Book.h"
+#include "../include/LatencyHistogram.h"
+#include "../include/MatchingEngine.h"
+#include "../include/Tsc.h"
+#include "BenchmarkWorkloads.h"
+
+namespace {
+
+LevelUpdateMode modeOf(int64_t arg) {
+    return arg == 0 ? LevelUpdateMode::Off : arg == 1 ? LevelUpdateMode::EveryChange : LevelUpdateMode::Conflated;
+}
+
+} // namespace
+
+// What publishing level updates costs the matching thread. The default
+// workload goes through processBatch with range(0) as the mode of every book:
+// 0 off, 1 every change, 2 conflated per batch. Only processBatch is timed;
+// the rings are drained between batches, outside the measurement.
+// updates_per_instruction shows how much conflation saves.
+static void BM_LevelUpdateCost(benchmark::State& state) {
+    const LevelUpdateMode mode = modeOf(state.range(0));
+    const std::vector<Instruction>& workload = defaultWorkload();
+    const double nanosPerTick = tscNanosPerTick();
+
+    uint64_t updates = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto engine = std::make_unique<MatchingEngine>(benchmarkTickers);
+        for (uint32_t t = 0; t < benchmarkTickers; ++t) engine->setLevelUpdateMode(t, mode);
+        state.ResumeTiming();
+
+        uint64_t ticks = 0;
+        InstructionResult results[Config::instructionBatchSize];
+        LevelUpdate drained[256];
+        for (size_t i = 0; i < workload.size(); i += Config::instructionBatchSize) {
+            const size_t n = std::min(Config::instructionBatchSize, workload.size() - i);
+            const uint64_t start = readTsc();
+            engine->processBatch(std::span<const Instruction>(workload.data() + i, n), std::span<InstructionResult>(results, n));
+            ticks += readTsc() - start;
+            for (uint32_t t = 0; t < benchmarkTickers; ++t) {
+                for (size_t k; (k = engine->pollLevelUpdates(t, drained, 256)) > 0;) updates += k;
+            }
+        }
+        state.SetIterationTime(static_cast<double>(ticks) * nanosPerTick * 1e-9);
+
+        state.PauseTiming();
+        engine.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * workload.size());
+    state.counters["updates_per_instruction"] =
+        static_cast<double>(updates) / static_cast<double>(std::max<uint64_t>(state.iterations() * workload.size(), 1));
+}
+
+// A consumer thread keeping an L2Book of every book while the benchmark
+// thread matches the default workload, in mode range(0) (1 every change, 2
+// conflated). backlog_p50/p99 are the updates waiting in a ring each time the
+// consumer finds any, its lag behind the matching thread. When a ring
+// overflows, the consumer asks the matching thread for a DepthSnapshot, which
+// it takes between batches; resyncs counts those.
+static void BM_LevelUpdateConsumerLag(benchmark::State& state) {
+    const LevelUpdateMode mode = modeOf(state.range(0));
+    const std::vector<Instruction>& workload = defaultWorkload();
+
+    LatencyHistogram backlog;
+    uint64_t resyncs = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto engine = std::make_unique<MatchingEngine>(benchmarkTickers);
+        for (uint32_t t = 0; t < benchmarkTickers; ++t) engine->setLevelUpdateMode(t, mode);
+        std::vector<L2Book> books(benchmarkTickers);
+        std::atomic<bool> matching{true};
+        std::vector<std::atomic<bool>> resyncWanted(benchmarkTickers);
+        std::mutex snapshotsLock;
+        std::vector<std::unique_ptr<DepthSnapshot>> snapshots(benchmarkTickers);
+        state.ResumeTiming();
+
+        std::thread consumer([&] {
+            LevelUpdate updates[256];
+            for (bool last = false; !last;) {
+                last = !matching.load(std::memory_order_acquire);
+                for (uint32_t t = 0; t < benchmarkTickers; ++t) {
+                    if (books[t].stale()) {
+                        std::unique_ptr<DepthSnapshot> snapshot;
+                        {
+                            std::lock_guard<std::mutex> guard(snapshotsLock);
+                            snapshot = std::move(snapshots[t]);
+                        }
+                        if (!snapshot) continue;
+                        books[t].resync(*snapshot);
+                        resyncs++;
+                    }
+                    if (const size_t pending = engine->pendingLevelUpdates(t)) backlog.record(pending);
+                    for (size_t n; (n = engine->pollLevelUpdates(t, updates, 256)) > 0;) {
+                        for (size_t k = 0; k < n; ++k) {
+                            if (!books[t].apply(updates[k])) {
+                                resyncWanted[t].store(true, std::memory_order_release);
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+        });
+
+        InstructionResult results[Config::instructionBatchSize];
+        for (size_t i = 0; i < workload.size(); i += Config::instructionBatchSize) {
+            const size_t n = std::min(Config::instructionBatchSize, workload.size() - i);
+            engine->processBatch(std::span<const Instruction>(workload.data() + i, n), std::span<InstructionResult>(results, n));
+            for (uint32_t t = 0; t < benchmarkTickers; ++t) {
+                if (resyncWanted[t].load(std::memory_order_relaxed) && resyncWanted[t].exchange(false)) {
+                    auto snapshot = std::make_unique<DepthSnapshot>(engine->depthSnapshot(t));
+                    std::lock_guard<std::mutex> guard(snapshotsLock);
+                    snapshots[t] = std::move(snapshot);
+                }
+            }
+        }
+        matching.store(false, std::memory_order_release);
+        consumer.join();
+
+        state.PauseTiming();
+        engine.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * workload.size());
+    state.counters["backlog_p50"] = static_cast<double>(backlog.valueAtPercentile(50.0));
+    state.counters["backlog_p99"] = static_cast<double>(backlog.valueAtPercentile(99.0));
+    state.counters["resyncs"] = benchmark::Counter(static_cast<double>(resyncs), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_LevelUpdateCost)
+    ->DenseRange(0, 2)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LevelUpdateConsumerLag)
+    ->DenseRange(1, 2)
+    ->Unit(benchmark::kMillisecond);
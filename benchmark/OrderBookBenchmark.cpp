@@ -0,0 +1,293 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "../include/OrderBook.h"
+#include "../include/MatchingEngine.h"
+#include "../include/LevelBitmap.h"
+#include "../include/Configuration.h"
+
+// Synthetic books live on a ladder of bookLevels ticks starting at baseTick.
+constexpr uint32_t baseTick = 500;
+constexpr size_t bookLevels = 501;
+
+static uint32_t levelPrice(size_t level) {
+    return baseTick + level;
+}
+
+// Cancels the only order at the best bid and puts it back, so every iteration
+// forces a best bid recovery. range(0) is the distance in levels between
+// resting bids: 1 is a dense book, bookLevels - 1 leaves just the
+// top and bottom levels occupied.
+static void BM_CancelAtTop(benchmark::State& state) {
+    const size_t spacing = state.range(0);
+    const size_t top = bookLevels - 1;
+    auto book = std::make_unique<OrderBook>();
+
+    uint32_t id = 1;
+    for (size_t level = top % spacing; level < top; level += spacing) {
+        book->processOrders(true, levelPrice(level), 100, 0, id++);
+    }
+    const uint32_t topId = id;
+    book->processOrders(true, levelPrice(top), 100, 0, topId);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book->cancelOrder(topId));
+        book->processOrders(true, levelPrice(top), 100, 0, topId);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_CancelAtTop)->Arg(1)->Arg(10)->Arg(100)->Arg(bookLevels - 1);
+
+// Next-best lookup on ladders far larger than the default one, with only the
+// first and last levels occupied.
+static void BM_LevelBitmapFindPrev(benchmark::State& state) {
+    const size_t levels = state.range(0);
+    LevelBitmap bitmap(levels);
+    bitmap.set(0);
+    bitmap.set(levels - 1);
+
+    for (auto _ : state) {
+        bitmap.clear(levels - 1);
+        benchmark::DoNotOptimize(bitmap.findPrevSet(levels - 1));
+        bitmap.set(levels - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_LevelBitmapFindPrev)->RangeMultiplier(64)->Range(512, 1 << 24);
+
+// Polls the top range(0) bid levels of a book holding 100 orders per level.
+static void BM_GetDepth(benchmark::State& state) {
+    const size_t nLevels = state.range(0);
+    auto book = std::make_unique<OrderBook>();
+
+    uint32_t id = 1;
+    for (size_t level = 0; level < bookLevels; ++level) {
+        for (int i = 0; i < 100; ++i) {
+            book->processOrders(true, levelPrice(level), 10, 0, id++);
+        }
+    }
+
+    std::vector<DepthLevel> depth(nLevels);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book->getDepth(true, nLevels, depth.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_GetDepth)->Arg(1)->Arg(10)->Arg(100);
+
+// A market that trends away from its opening price: a band of range(0) levels
+// of bids and asks around a mid that moves up one tick every round. Orders
+// left behind the band are cancelled, so the ladder has to keep following.
+static void BM_TrendingMarket(benchmark::State& state) {
+    const size_t band = state.range(0);
+    auto book = std::make_unique<OrderBook>();
+
+    size_t mid = 500;
+    uint32_t nextId = 1;
+    for (auto _ : state) {
+        book->processOrders(true, static_cast<uint32_t>(mid - band), 10, 0, nextId);
+        book->processOrders(false, static_cast<uint32_t>(mid + band), 10, 0, nextId + 1);
+        if (nextId > 2 * band) {
+            book->cancelOrder(nextId - 2 * band);
+            book->cancelOrder(nextId - 2 * band + 1);
+        }
+        nextId += 2;
+        if (++mid + band >= Config::maxPriceTicks) { // Start over at the bottom of the grid
+            state.PauseTiming();
+            book = std::make_unique<OrderBook>();
+            mid = 500;
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 4);
+    state.counters["ladder_bytes"] = book->ladderMemoryUsage();
+}
+
+BENCHMARK(BM_TrendingMarket)->Arg(16)->Arg(256);
+
+// Crossing flow that fills 8 resting asks spread over 4 levels per iteration.
+// range(0) picks what happens to the execution reports:
+//   0 - nobody drains the ring, so it saturates and reports are dropped
+//   1 - drained on the matching thread after every sweep
+//   2 - drained by a consumer thread
+static void BM_ExecutionReports(benchmark::State& state) {
+    const int mode = static_cast<int>(state.range(0));
+    auto book = std::make_unique<OrderBook>();
+    SpscRing<ExecutionReport>& ring = book->executionReports();
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> consumed{0};
+    std::thread consumer;
+    if (mode == 2) {
+        consumer = std::thread([&] {
+            ExecutionReport batch[256];
+            uint64_t n = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                n += ring.popBatch(batch, 256);
+            }
+            consumed.store(n, std::memory_order_relaxed);
+        });
+    }
+
+    ExecutionReport batch[16];
+    uint64_t drained = 0;
+    uint32_t id = 1;
+    for (auto _ : state) {
+        for (size_t i = 0; i < 8; ++i) {
+            book->processOrders(false, levelPrice(i / 2), 10, 0, id++);
+        }
+        benchmark::DoNotOptimize(book->processOrders(true, levelPrice(3), 80, 0, id++));
+        if (mode == 1) {
+            drained += ring.popBatch(batch, 16);
+        }
+    }
+
+    if (mode == 2) {
+        stop.store(true, std::memory_order_relaxed);
+        consumer.join();
+        drained = consumed.load(std::memory_order_relaxed);
+    }
+    state.SetItemsProcessed(state.iterations() * 9);
+    state.counters["fills"] = benchmark::Counter(state.iterations() * 8, benchmark::Counter::kIsRate);
+    state.counters["drained"] = drained;
+    state.counters["dropped"] = book->droppedExecutionReports();
+}
+
+BENCHMARK(BM_ExecutionReports)->Arg(0)->Arg(1)->Arg(2)->UseRealTime();
+
+// One order of the given type per iteration against a book with 10 asks of
+// 10 on each of the 10 levels above the bids. range(0) = 0 prices it inside
+// the spread, 1 crosses and takes 10 from the best ask. Whatever the order
+// took or left is undone before the next iteration.
+template <OrderType Type>
+static void BM_OrderType(benchmark::State& state) {
+    const bool crossing = state.range(0) != 0;
+    auto book = std::make_unique<OrderBook>();
+
+    uint32_t id = 1;
+    for (size_t level = 0; level < 10; ++level) {
+        for (int i = 0; i < 10; ++i) {
+            book->processOrders(true, levelPrice(level), 10, 0, id++);
+            book->processOrders(false, levelPrice(level + 11), 10, 0, id++);
+        }
+    }
+
+    const uint32_t price = crossing ? levelPrice(11) : levelPrice(10);
+    for (auto _ : state) {
+        ExecutionSummary summary = book->processOrders(Type, true, price, 10, 0, id);
+        if (summary.restingQuantity > 0) {
+            book->cancelOrder(id);
+        }
+        if (summary.filledQuantity > 0) {
+            book->processOrders(false, levelPrice(11), summary.filledQuantity, 0, id + 1);
+        }
+        id += 2;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_OrderType, OrderType::Limit)->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(BM_OrderType, OrderType::ImmediateOrCancel)->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(BM_OrderType, OrderType::FillOrKill)->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(BM_OrderType, OrderType::Market)->Arg(1);
+BENCHMARK_TEMPLATE(BM_OrderType, OrderType::PostOnly)->Arg(0)->Arg(1);
+
+// Amends of one order in a book of 100 orders per level on 10 bid and 10 ask
+// levels. range(0) picks the amend:
+//   0 - quantity down at the same price, keeping priority
+//   1 - price move between two bid levels, never marketable
+//   2 - price move through the ask side, which takes 10 from the best ask
+//       that is then put back
+static void BM_EditOrder(benchmark::State& state) {
+    const int kind = static_cast<int>(state.range(0));
+    auto book = std::make_unique<OrderBook>();
+
+    uint32_t id = 1;
+    for (size_t level = 0; level < 10; ++level) {
+        for (int i = 0; i < 100; ++i) {
+            book->processOrders(true, levelPrice(level), 10, 0, id++);
+            book->processOrders(false, levelPrice(level + 11), 10, 0, id++);
+        }
+    }
+    const uint32_t target = id++;
+    book->processOrders(true, levelPrice(5), 1'000'000, 0, target);
+
+    uint32_t quantity = 1'000'000;
+    bool up = false;
+    for (auto _ : state) {
+        switch (kind) {
+        case 0:
+            benchmark::DoNotOptimize(book->editOrder(target, levelPrice(5), --quantity));
+            break;
+        case 1:
+            benchmark::DoNotOptimize(book->editOrder(target, levelPrice(up ? 5 : 6), quantity));
+            up = !up;
+            break;
+        default:
+            benchmark::DoNotOptimize(book->editOrder(target, levelPrice(up ? 5 : 11), 20));
+            if (!up) {
+                book->processOrders(false, levelPrice(11), 10, 0, id++);
+            }
+            up = !up;
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_EditOrder)->Arg(0)->Arg(1)->Arg(2);
+
+// Random cancel and re-add of resting orders in a book of range(1) orders, so
+// both the ID index slot and the order record are usually cache misses.
+// range(0) = 0 sends one call per instruction, 1 sends batches of 64 through
+// processBatch, which prefetches ahead.
+static void BM_BatchedCancels(benchmark::State& state) {
+    const bool batched = state.range(0) != 0;
+    const uint32_t orders = static_cast<uint32_t>(state.range(1));
+    auto engine = std::make_unique<MatchingEngine>();
+
+    for (uint32_t id = 1; id <= orders; ++id) {
+        engine->processOrders(0, true, levelPrice(id % bookLevels), 10, 0, id);
+    }
+
+    std::vector<Instruction> batch(64);
+    std::vector<InstructionResult> results(64);
+    uint32_t rng = 0x9e3779b9;
+    for (auto _ : state) {
+        for (size_t i = 0; i < batch.size(); i += 2) {
+            rng = rng * 1664525 + 1013904223;
+            uint32_t id = 1 + (rng >> 4) % orders;
+            uint32_t price = levelPrice(id % bookLevels);
+            batch[i] = {0, id, price, 10, 0, InstructionAction::Cancel, 0};
+            batch[i + 1] = {0, id, price, 10, 0, InstructionAction::Add, Instruction::makeFlags(true)};
+        }
+        if (batched) {
+            engine->processBatch(batch, results);
+        } else {
+            for (const Instruction& instruction : batch) {
+                if (instruction.action == InstructionAction::Cancel) {
+                    benchmark::DoNotOptimize(engine->cancelOrder(0, instruction.ID));
+                } else {
+                    engine->processOrders(0, true, instruction.price, instruction.quantity, 0, instruction.ID);
+                }
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * batch.size());
+}
+
+BENCHMARK(BM_BatchedCancels)->ArgsProduct({{0, 1}, {1 << 16, 1 << 21}});
@@ -0,0 +1,68 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+
+#include "../include/OrderPool.h"
+
+// A fresh pool filled with range(0) orders: the cost a book pays the first
+// time it fills up, slabs from the shared arena and page faults included.
+static void BM_OrderPoolColdFill(benchmark::State& state) {
+    const uint32_t n = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state) {
+        auto pool = std::make_unique<OrderPool>();
+        for (uint32_t i = 0; i < n; ++i) {
+            benchmark::DoNotOptimize(pool->allocate(i, true, 500, 10, i));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_OrderPoolColdFill)->Arg(1 << 16)->Arg(1 << 20)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+
+// The same fill on a pool reserved outside the timed region.
+static void BM_OrderPoolPrewarmedFill(benchmark::State& state) {
+    const uint32_t n = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto pool = std::make_unique<OrderPool>();
+        pool->reserve(n);
+        state.ResumeTiming();
+        for (uint32_t i = 0; i < n; ++i) {
+            benchmark::DoNotOptimize(pool->allocate(i, true, 500, 10, i));
+        }
+        state.PauseTiming();
+        pool.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_OrderPoolPrewarmedFill)->Arg(1 << 16)->Arg(1 << 20)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+
+// Steady-state release/reuse of slots through the free list.
+static void BM_OrderPoolChurn(benchmark::State& state) {
+    OrderPool pool;
+    pool.reserve(1024);
+    OrderIndex slots[1024];
+    for (uint32_t i = 0; i < 1024; ++i) {
+        slots[i] = pool.allocate(i, true, 500, 10, i);
+    }
+
+    uint32_t rng = 0x9e3779b9;
+    for (auto _ : state) {
+        rng = rng * 1664525 + 1013904223;
+        OrderIndex& slot = slots[rng >> 22];
+        pool.deallocate(slot);
+        slot = pool.allocate(rng, true, 500, 10, rng);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+
+BENCHMARK(BM_OrderPoolChurn);
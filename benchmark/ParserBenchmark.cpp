@@ -0,0 +1,75 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "../include/Configuration.h"
+#include "../include/InstructionParser.h"
+
+// An in-memory text feed of about 1 MB shaped like GenerateData's: its
+// instruction mix, with cancels carrying a zero price and quantity and
+// cancels and edits naming recent orders. Parsing runs without I/O or
+// matching.
+static const std::string& parserInput() {
+    static const std::string input = []() {
+        std::string text;
+        uint32_t rng = 0x9e3779b9;
+        uint32_t id = Config::initialOrderId;
+        uint64_t timestamp = Config::initialTimestamp;
+        char line[128];
+        while (text.size() < (1 << 20)) {
+            rng = rng * 1664525 + 1013904223;
+            const char side = (rng & 1) ? 'B' : 'S';
+            const int price = static_cast<int>(Config::minGenPrice * 100) + static_cast<int>((rng >> 8) % 45000);
+            const unsigned qty = 10 * (Config::minGenQty + (rng >> 20) % Config::maxGenQty);
+            const unsigned long long ts = timestamp++;
+            const int kind = static_cast<int>((rng >> 4) % 100);
+            int length;
+            if (kind < Config::addInstructionWeight) {
+                length = std::snprintf(line, sizeof(line), "%u;AAPL;%c;%d.%02d;%u;A;%llu\n", id++, side, price / 100, price % 100, qty, ts);
+            } else if (kind < Config::addInstructionWeight + Config::cancelInstructionWeight) {
+                length = std::snprintf(line, sizeof(line), "%u;AAPL;%c;0.00;0;C;%llu\n", id - 1 - (rng >> 24) % 64, side, ts);
+            } else {
+                length = std::snprintf(line, sizeof(line), "%u;AAPL;%c;%d.%02d;%u;E;%llu\n", id - 1 - (rng >> 24) % 64, side, price / 100, price % 100, qty, ts);
+            }
+            text.append(line, length);
+        }
+        return text;
+    }();
+    return input;
+}
+
+// range(0) is the ParserIsa; Scalar is the line-at-a-time decoder. Batches
+// are the replay's size.
+static void BM_ParseInstructions(benchmark::State& state) {
+    const ParserIsa isa = static_cast<ParserIsa>(state.range(0));
+    if (isa > detectParserIsa()) {
+        state.SkipWithError("instruction set not supported by this CPU");
+        return;
+    }
+    state.SetLabel(parserIsaName(isa));
+
+    const std::string& input = parserInput();
+    Instruction batch[Config::instructionBatchSize];
+    size_t parsed = 0;
+    for (auto _ : state) {
+        const char* p = input.data();
+        const char* end = p + input.size();
+        size_t skipped = 0;
+        while (p < end) {
+            parsed += parseInstructions(isa, p, end, 0, batch, Config::instructionBatchSize, skipped);
+            benchmark::DoNotOptimize(batch);
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+    state.SetItemsProcessed(parsed);
+}
+
+BENCHMARK(BM_ParseInstructions)->DenseRange(static_cast<int>(ParserIsa::Scalar), static_cast<int>(ParserIsa::Avx2));
@@ -0,0 +1,87 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "../include/Configuration.h"
+#include "../include/ShardedEngine.h"
+
+// range(0) producer threads submit to range(1) shards, 2^18 instructions in
+// all. Each producer sends adds across every ticker under its own IDs, and
+// cancels of its own recent adds; a refused submit() is retried after a
+// yield. Throughput counts from the first submit to the last instruction
+// matched.
+static void BM_ShardedEngine(benchmark::State& state) {
+    const size_t producers = static_cast<size_t>(state.range(0));
+    const size_t shards = static_cast<size_t>(state.range(1));
+    const size_t perProducer = (size_t{1} << 18) / producers;
+    const uint32_t tickers = static_cast<uint32_t>(Config::tickers.size());
+
+    ShardedEngine::ShardStats total;
+    uint64_t retries = 0;
+    for (auto _ : state) {
+        ShardedEngine engine(shards);
+        engine.start();
+
+        std::atomic<uint64_t> producerRetries{0};
+        std::vector<std::thread> threads;
+        for (size_t p = 0; p < producers; ++p) {
+            threads.emplace_back([&, p]() {
+                const uint32_t base = static_cast<uint32_t>(p << 24);
+                auto tickerOf = [&](uint32_t id) { return (id * 2654435761u >> 16) % tickers; };
+                uint32_t rng = 0x9e3779b9 + static_cast<uint32_t>(p);
+                uint32_t next = 0;
+                uint64_t localRetries = 0;
+                for (size_t i = 0; i < perProducer; ++i) {
+                    rng = rng * 1664525 + 1013904223;
+                    Instruction instruction{};
+                    if (next > 64 && (rng >> 28) < 4) {
+                        instruction.ID = base + next - 1 - (rng >> 8) % 64;
+                        instruction.action = InstructionAction::Cancel;
+                    } else {
+                        instruction.ID = base + next++;
+                        instruction.price = 1000 + (rng >> 8) % 64;
+                        instruction.quantity = 10 + (rng >> 20) % 90;
+                        instruction.flags = Instruction::makeFlags(rng & 1);
+                    }
+                    instruction.tickerId = static_cast<uint16_t>(tickerOf(instruction.ID));
+                    instruction.timestamp = i;
+                    while (!engine.submit(instruction)) {
+                        localRetries++;
+                        std::this_thread::yield();
+                    }
+                }
+                producerRetries.fetch_add(localRetries, std::memory_order_relaxed);
+            });
+        }
+        for (auto& t : threads) t.join();
+        engine.stop();
+
+        for (size_t s = 0; s < shards; ++s) {
+            ShardedEngine::ShardStats stats = engine.stats(s);
+            total.processed += stats.processed;
+            total.rejectedSubmits += stats.rejectedSubmits;
+            total.queueLatencyNsTotal += stats.queueLatencyNsTotal;
+            total.queueLatencyNsMax = std::max(total.queueLatencyNsMax, stats.queueLatencyNsMax);
+        }
+        retries += producerRetries.load();
+    }
+
+    state.SetItemsProcessed(total.processed);
+    state.counters["queue_ns_mean"] = total.processed ? static_cast<double>(total.queueLatencyNsTotal) / total.processed : 0.0;
+    state.counters["queue_ns_max"] = static_cast<double>(total.queueLatencyNsMax);
+    state.counters["rejected"] = benchmark::Counter(static_cast<double>(retries), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_ShardedEngine)
+    ->ArgsProduct({{1, 2, 4}, {1, 2, 4}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,128 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+
+#include "../include/BookSnapshot.h"
+#include "../include/MatchingEngine.h"
+#include "../include/Tsc.h"
+
+namespace {
+
+constexpr size_t snapshotTickers = 10;
+constexpr uint32_t midTick = 1 << 20;
+constexpr uint32_t levelsPerSide = 1000;
+
+// restingOrders orders spread over snapshotTickers books, each with
+// levelsPerSide bid and ask levels around midTick. Built once per size.
+MatchingEngine& restingEngine(size_t restingOrders) {
+    static std::map<size_t, std::unique_ptr<MatchingEngine>> cache;
+    auto& engine = cache[restingOrders];
+    if (!engine) {
+        engine = std::make_unique<MatchingEngine>(snapshotTickers);
+        for (uint32_t i = 0; i < restingOrders; ++i) {
+            const uint32_t tickerId = i % snapshotTickers;
+            const uint32_t n = i / snapshotTickers;
+            const bool isBuy = n % 2 == 0;
+            const uint32_t level = (n / 2) % levelsPerSide;
+            engine->processOrders(tickerId, isBuy, isBuy ? midTick - 1 - level : midTick + 1 + level, 1 + n % 100, n, i + 1);
+        }
+    }
+    return *engine;
+}
+
+std::string snapshotPath() {
+    return (std::filesystem::temp_directory_path() / "orderbook_benchmark.snap").string();
+}
+
+} // namespace
+
+// Snapshots range(0) resting orders over 10 books into a file, synced to
+// disk: capture, parallel section writes and fdatasync.
+static void BM_SnapshotWrite(benchmark::State& state) {
+    const size_t restingOrders = static_cast<size_t>(state.range(0));
+    MatchingEngine& engine = restingEngine(restingOrders);
+    const std::string path = snapshotPath();
+
+    for (auto _ : state) {
+        if (!engine.writeSnapshot(path)) {
+            state.SkipWithError("Cannot write the snapshot file");
+            break;
+        }
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations() * restingOrders);
+    state.SetBytesProcessed(state.iterations() * restingOrders * sizeof(SnapshotOrder));
+}
+
+// Restores the same snapshot into a fresh engine: mapping the file and
+// rebuilding the 10 books in parallel.
+static void BM_SnapshotRestore(benchmark::State& state) {
+    const size_t restingOrders = static_cast<size_t>(state.range(0));
+    const std::string path = snapshotPath();
+    if (!restingEngine(restingOrders).writeSnapshot(path)) {
+        state.SkipWithError("Cannot write the snapshot file");
+        return;
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto engine = std::make_unique<MatchingEngine>(snapshotTickers);
+        state.ResumeTiming();
+
+        if (!engine->restoreSnapshot(path)) {
+            state.SkipWithError("Cannot restore the snapshot file");
+            break;
+        }
+
+        state.PauseTiming();
+        engine.reset();
+        state.ResumeTiming();
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations() * restingOrders);
+}
+
+// One SnapshotCapture step of range(1) orders on one of the 10 books holding
+// range(0) resting orders between them: how long a live capture holds the
+// book between two instructions.
+static void BM_SnapshotCaptureStep(benchmark::State& state) {
+    const size_t restingOrders = static_cast<size_t>(state.range(0));
+    const size_t stepOrders = static_cast<size_t>(state.range(1));
+    OrderBook& book = const_cast<OrderBook&>(*restingEngine(restingOrders).getOrderBook(0));
+    const double nanosPerTick = tscNanosPerTick();
+
+    auto capture = std::make_unique<SnapshotCapture>(book);
+    for (auto _ : state) {
+        const uint64_t start = readTsc();
+        const bool complete = capture->step(stepOrders);
+        const uint64_t end = readTsc();
+        state.SetIterationTime(static_cast<double>(end - start) * nanosPerTick * 1e-9);
+        if (complete) {
+            capture.reset();
+            capture = std::make_unique<SnapshotCapture>(book);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * stepOrders);
+}
+
+BENCHMARK(BM_SnapshotWrite)
+    ->Arg(1 << 20)->Arg(10'000'000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SnapshotRestore)
+    ->Arg(1 << 20)->Arg(10'000'000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SnapshotCaptureStep)
+    ->ArgsProduct({{10'000'000}, {256, 4096}})
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
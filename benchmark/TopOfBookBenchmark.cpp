@@ -0,0 +1,107 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "../include/Configuration.h"
+#include "../include/LatencyHistogram.h"
+#include "../include/MatchingEngine.h"
+#include "../include/Tsc.h"
+#include "BenchmarkWorkloads.h"
+
+// One matching thread runs the default workload through processBatch while
+// range(0) reader threads call getBBO on every book in turn, as fast as they
+// can. Only processBatch is timed, so items_per_second against the 0 readers
+// case is the writer's slowdown. read_p50_ns/read_p99_ns are the latency of
+// single getBBO calls, TSC overhead included, and reads_per_second is the
+// throughput of each reader. Readers need cores of their own for either to
+// mean much.
+static void BM_TopOfBookReaders(benchmark::State& state) {
+    const size_t readerCount = static_cast<size_t>(state.range(0));
+    const std::vector<Instruction>& workload = defaultWorkload();
+    const double nanosPerTick = tscNanosPerTick();
+
+    std::vector<LatencyHistogram> latencies(readerCount);
+    std::vector<uint64_t> reads(readerCount, 0);
+    uint64_t readTicks = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto engine = std::make_unique<MatchingEngine>(benchmarkTickers);
+        std::atomic<bool> started{false};
+        std::atomic<bool> matching{true};
+        std::vector<std::thread> readers;
+        for (size_t r = 0; r < readerCount; ++r) {
+            readers.emplace_back([&, r] {
+                // Counted locally: neighbouring slots of latencies and reads
+                // would share cache lines between readers.
+                LatencyHistogram latency;
+                uint64_t count = 0;
+                uint32_t tickerId = static_cast<uint32_t>(r % benchmarkTickers);
+                while (!started.load(std::memory_order_acquire)) std::this_thread::yield();
+                while (matching.load(std::memory_order_relaxed)) {
+                    const uint64_t start = readTsc();
+                    TopOfBook top = engine->getBBO(tickerId);
+                    const uint64_t end = readTsc();
+                    benchmark::DoNotOptimize(top);
+                    latency.record(end - start);
+                    count++;
+                    if (++tickerId == benchmarkTickers) tickerId = 0;
+                }
+                latencies[r].merge(latency);
+                reads[r] += count;
+            });
+        }
+        state.ResumeTiming();
+
+        const uint64_t begin = readTsc();
+        started.store(true, std::memory_order_release);
+        uint64_t ticks = 0;
+        InstructionResult results[Config::instructionBatchSize];
+        for (size_t i = 0; i < workload.size(); i += Config::instructionBatchSize) {
+            const size_t n = std::min(Config::instructionBatchSize, workload.size() - i);
+            const uint64_t start = readTsc();
+            engine->processBatch(std::span<const Instruction>(workload.data() + i, n), std::span<InstructionResult>(results, n));
+            ticks += readTsc() - start;
+        }
+        state.SetIterationTime(static_cast<double>(ticks) * nanosPerTick * 1e-9);
+
+        state.PauseTiming();
+        matching.store(false, std::memory_order_relaxed);
+        readTicks += readTsc() - begin;
+        for (std::thread& reader : readers) reader.join();
+        engine.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * workload.size());
+    if (readerCount == 0) return;
+
+    LatencyHistogram all;
+    uint64_t totalReads = 0;
+    for (size_t r = 0; r < readerCount; ++r) {
+        all.merge(latencies[r]);
+        totalReads += reads[r];
+    }
+    state.counters["read_p50_ns"] = static_cast<double>(all.valueAtPercentile(50.0)) * nanosPerTick;
+    state.counters["read_p99_ns"] = static_cast<double>(all.valueAtPercentile(99.0)) * nanosPerTick;
+    state.counters["reads_per_second"] =
+        static_cast<double>(totalReads) / static_cast<double>(readerCount) / (static_cast<double>(readTicks) * nanosPerTick * 1e-9);
+}
+
+BENCHMARK(BM_TopOfBookReaders)
+    ->Arg(0)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
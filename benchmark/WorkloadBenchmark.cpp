@@ -0,0 +1,59 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "../include/Configuration.h"
+#include "../include/MatchingEngine.h"
+#include "BenchmarkWorkloads.h"
+
+// The default workload model replayed through processBatch on one thread,
+// with nothing read from disk. range(0) tickers, their activity Zipf with
+// exponent range(1) / 10 (0 = equal volume), and range(2) percent of adds
+// marketable. fill_ratio is fills per add.
+static void BM_ModelledWorkload(benchmark::State& state) {
+    WorkloadModel model;
+    model.tickerCount = static_cast<size_t>(state.range(0));
+    model.tickerZipfExponent = state.range(1) / 10.0;
+    model.marketableRatio = state.range(2) / 100.0;
+    const std::vector<Instruction>& workload = modelledWorkload(model);
+
+    uint64_t adds = 0;
+    uint64_t fills = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto engine = std::make_unique<MatchingEngine>(model.tickerCount);
+        state.ResumeTiming();
+
+        InstructionResult results[Config::instructionBatchSize];
+        for (size_t i = 0; i < workload.size(); i += Config::instructionBatchSize) {
+            const size_t n = std::min(Config::instructionBatchSize, workload.size() - i);
+            engine->processBatch(std::span<const Instruction>(workload.data() + i, n), std::span<InstructionResult>(results, n));
+            for (size_t j = 0; j < n; ++j) {
+                if (workload[i + j].action == InstructionAction::Add) {
+                    adds++;
+                    fills += results[j].summary.fills;
+                }
+            }
+        }
+
+        state.PauseTiming();
+        engine.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * workload.size());
+    state.counters["fill_ratio"] = adds ? static_cast<double>(fills) / adds : 0.0;
+}
+
+BENCHMARK(BM_ModelledWorkload)
+    ->ArgsProduct({{10, 1000}, {0, 11}, {5, 30}})
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,101 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+
+#ifndef BOOK_SCHEDULER_INCLUDED
+#define BOOK_SCHEDULER_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Instruction.h"
+#include "MatchingEngine.h"
+#include "MpscRing.h"
+#include "WorkStealingQueue.h"
+
+// Runs the books of a MatchingEngine on a fixed pool of workers, however many
+// books there are. A book is the unit of work: submit() queues an instruction
+// in the book's inbox, and a book with queued instructions is a ready task on
+// exactly one worker's queue. Workers run their own ready books oldest first,
+// each for at most Config::bookRunBudget instructions, and when they run dry
+// steal from the others, so a handful of hot books spread over the pool while
+// cold ones cost nothing. A book is matched by one worker at a time, and a
+// ticker's instructions from one producer in the order they were submitted.
+class BookScheduler {
+public:
+  // What a worker has done so far. A snapshot; the counts move while it runs.
+  struct WorkerStats {
+    uint64_t processed = 0;
+    uint64_t accepted = 0;  // See InstructionResult::accepted
+    uint64_t bookRuns = 0;  // Times a book was taken and matched
+    uint64_t steals = 0;    // Book runs taken from another worker's queue
+  };
+
+  // Schedules the books of engine, which must outlive the scheduler and not
+  // be used elsewhere while it runs. workerCount 0 means one per hardware
+  // thread.
+  explicit BookScheduler(MatchingEngine& engine, size_t workerCount = 0);
+  ~BookScheduler();
+
+  BookScheduler(const BookScheduler&) = delete;
+  BookScheduler& operator=(const BookScheduler&) = delete;
+
+  void start();
+  // Lets the workers drain every book, then joins them. Producers must have
+  // stopped submitting.
+  void stop();
+
+  // Never blocks. Returns false when the book's inbox is full, leaving the
+  // caller to retry, slow down or shed the instruction, and for an unknown
+  // ticker.
+  bool submit(const Instruction& instruction);
+
+  size_t workerCount() const { return workers.size(); }
+  WorkerStats stats(size_t worker) const;
+  // submit() calls refused because a book's inbox was full.
+  uint64_t rejectedSubmits() const { return rejected.load(std::memory_order_relaxed); }
+
+private:
+  static constexpr size_t cacheLine = 64;
+
+  struct alignas(cacheLine) Book {
+    explicit Book(size_t capacity) : inbox(capacity) {}
+
+    MpscRing<Instruction> inbox;
+    // Set while the book is on a queue or being matched
+    std::atomic<bool> scheduled{false};
+  };
+
+  struct Worker {
+    explicit Worker(size_t books) : queue(books), handoff(books) {}
+
+    WorkStealingQueue queue;
+    // Books made ready by submit(), moved onto the queue by the worker
+    MpscRing<uint32_t> handoff;
+    std::thread thread;
+    // Written by the worker only
+    std::atomic<uint64_t> processed{0};
+    std::atomic<uint64_t> accepted{0};
+    std::atomic<uint64_t> bookRuns{0};
+    std::atomic<uint64_t> steals{0};
+  };
+
+  void run(size_t self);
+  uint32_t next(size_t self, uint32_t& rng);
+  void runBook(Worker& worker, uint32_t tickerId);
+
+  MatchingEngine& matchingEngine;
+  std::vector<std::unique_ptr<Book>> books;
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::atomic<bool> running{false};
+  std::atomic<uint64_t> rejected{0};
+};
+
+#endif // !BOOK_SCHEDULER_INCLUDED
@@ -0,0 +1,140 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef BOOK_SNAPSHOT_INCLUDED
+#define BOOK_SNAPSHOT_INCLUDED
+
+#include <cstdint>
+#include <map>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Configuration.h"
+#include "PriceLadder.h"
+
+class OrderBook;
+
+// Snapshot file: a SnapshotFileHeader, sectionCount SnapshotSection entries,
+// then one section per ticker at its offset. A section holds the ticker's
+// SnapshotLevel records, bids best first and then asks best first, followed
+// by its SnapshotOrder records level by level in queue order. Everything is
+// little-endian and 8-byte aligned, laid out as in memory, so a restore maps
+// the file and reads records in place. Bump version whenever a layout changes.
+struct SnapshotFileHeader {
+  static constexpr char expectedMagic[8] = {'O', 'B', 'S', 'S', 'N', 'A', 'P', '\0'};
+  static constexpr uint32_t currentVersion = 1;
+
+  char magic[8];
+  uint32_t version;
+  uint32_t ticksPerUnit; // Price grid of the levels
+  uint32_t levelSize;
+  uint32_t orderSize;
+  uint32_t sectionCount;
+  uint32_t reserved;
+};
+
+struct SnapshotSection {
+  static constexpr size_t nameSize = 32;
+
+  uint64_t offset; // From the start of the file
+  uint64_t orderCount;
+  uint64_t reportSequence; // Sequence number of the book's next execution report
+  uint32_t tickerId;
+  uint32_t bidLevels;
+  uint32_t askLevels;
+  uint32_t reserved;
+  char name[nameSize]; // Ticker name, truncated to nameSize - 1 characters
+};
+
+struct SnapshotLevel {
+  uint32_t price; // In ticks
+  uint32_t orderCount;
+};
+
+struct SnapshotOrder {
+  uint32_t ID;
+  uint32_t quantity;
+  uint32_t timestamp;
+};
+
+static_assert(sizeof(SnapshotFileHeader) == 32, "Header keeps sections 8-byte aligned");
+static_assert(sizeof(SnapshotSection) == 72, "Directory entries are packed");
+static_assert(sizeof(SnapshotLevel) == 8 && sizeof(SnapshotOrder) == 12, "Records are packed");
+
+// Resting orders of one book in price-time order, laid out as a section.
+// levels and orders are spans so that a restore can point them into a mapped
+// file; BookImage owns its records.
+struct BookImageView {
+  std::span<const SnapshotLevel> levels; // bidLevels bids, then the asks
+  std::span<const SnapshotOrder> orders;
+  uint32_t bidLevels = 0;
+  uint64_t reportSequence = 0;
+};
+
+struct BookImage {
+  std::vector<SnapshotLevel> levels;
+  std::vector<SnapshotOrder> orders;
+  uint32_t bidLevels = 0;
+  uint64_t reportSequence = 0;
+
+  BookImageView view() const { return {levels, orders, bidLevels, reportSequence}; }
+};
+
+// Captures a BookImage of a book that keeps trading meanwhile, a slice at a
+// time. Each step() must run on the thread that owns the book, between two
+// of its instructions. The first pass copies levels outward from the best
+// prices. Every level the book changes after the capture began is noted by
+// the book, and copied again by later steps, until few enough are left for
+// one step to copy them all (Config::snapshotFinalLevels). The image is then
+// the book as it stood at the end of that step, and the book was never held
+// for more than one step. A book runs one capture at a time.
+class SnapshotCapture {
+public:
+  explicit SnapshotCapture(OrderBook& book);
+  ~SnapshotCapture();
+  SnapshotCapture(const SnapshotCapture&) = delete;
+  SnapshotCapture& operator=(const SnapshotCapture&) = delete;
+
+  // Copies about maxOrders more orders, at least one level; the final step
+  // may copy more. Returns true once the capture is complete.
+  bool step(size_t maxOrders);
+  // The captured book, once step() has returned true. Reads nothing of the
+  // book, so it may run on another thread.
+  BookImage take();
+
+private:
+  struct LevelCopy {
+    size_t first; // In copies
+    uint32_t count;
+  };
+
+  size_t copyLevel(bool isBuy, size_t tick);
+  void compact();
+
+  OrderBook& book;
+  std::vector<SnapshotOrder> copies; // Every level copied so far, stale copies included
+  std::map<uint32_t, LevelCopy> bids;
+  std::map<uint32_t, LevelCopy> asks;
+  size_t liveOrders = 0; // Orders in the copies bids and asks point to
+  size_t bidCursor = PriceLadder::npos - 1; // Next bid level at or below this
+  size_t askCursor = 0;                     // Next ask level at or above this
+  bool bidsScanned = false;
+  bool scanned = false;
+  std::vector<std::pair<bool, uint32_t>> pending; // Changed levels to copy again
+  bool recopied = false;
+  bool complete = false;
+  uint64_t reportSequence = 0; // The book's, when the capture completed
+};
+
+// Writes one section per image; names[i] is the ticker name of images[i],
+// whose tickerId is i. Sections are written by up to threads threads (0 for
+// one per hardware thread). Returns false if the file cannot be written.
+bool writeSnapshotFile(const std::string& path, const std::vector<BookImage>& images,
+                       const std::vector<std::string>& names, size_t threads = 0);
+
+#endif // !BOOK_SNAPSHOT_INCLUDED
@@ -16,13 +16,89 @@
 namespace Config {
 
 // === Order Book Configuration ===
-constexpr double minPrice = 50.0;
-constexpr double tickSize = 0.1;
-constexpr size_t priceLevels = 501;
+// Prices are integer ticks internally; a tick is 1 / ticksPerUnit of a price unit.
+constexpr uint32_t ticksPerUnit = 10;
+constexpr double tickSize = 1.0 / ticksPerUnit;
+// Any price on the tick grid below maxPriceTicks * tickSize is accepted.
+constexpr size_t maxPriceTicks = size_t{1} << 24;
+// The ladder is allocated in pages of 2^ladderPageShift levels; pages without
+// orders are released. A fresh ladder window spans ladderInitialPages pages.
+constexpr size_t ladderPageShift = 9;
+constexpr size_t ladderInitialPages = 8;
+
+// === Order ID Index Configuration ===
+// DirectIdTable pages cover 2^idTablePageShift consecutive order IDs.
+constexpr size_t idTablePageShift = 10;
+
+// === Execution Report Configuration ===
+// Each fill is pushed as an ExecutionReport into a per-book ring of
+// executionReportRingSize entries; reports are dropped while it is full.
+// false compiles reporting out of the matching loop altogether.
+constexpr bool emitExecutionReports = true;
+constexpr size_t executionReportRingSize = 4096;
+
+// === Market Data Configuration ===
+// Each book publishes a LevelUpdate per price level change into a ring of
+// levelUpdateRingSize entries; updates are dropped while it is full. Books
+// start out conflating when conflateLevelUpdates is set (see
+// OrderBook::publishLevelUpdates), and publishing every change otherwise.
+constexpr size_t levelUpdateRingSize = 4096;
+constexpr bool conflateLevelUpdates = true;
+// A conflating book folds a change into a pending update of the same level
+// among the last levelUpdateConflationWindow, and publishes its pending
+// updates anyway once there are levelUpdateConflationLimit of them.
+constexpr size_t levelUpdateConflationWindow = 4;
+constexpr size_t levelUpdateConflationLimit = 1024;
+
+// === Batch Processing Configuration ===
+// MatchingEngine::processBatch prefetches the ID index slot of a cancel or
+// edit 2 * batchPrefetchDistance instructions ahead, and its order record
+// batchPrefetchDistance ahead. The second stage costs an extra index probe,
+// which only pays off once books outgrow the cache; 0 turns prefetching off.
+constexpr size_t batchPrefetchDistance = 4;
+
+// === Sharded Engine Configuration ===
+// Instructions each shard's ingress queue holds before submit() refuses more.
+constexpr size_t shardQueueCapacity = 65536;
+// Empty polls a worker spins through before it starts yielding its core; also
+// used by BookScheduler's workers.
+constexpr size_t shardIdleSpins = 256;
+
+// === Book Scheduler Configuration ===
+// Instructions a book's inbox holds before BookScheduler::submit() refuses more.
+constexpr size_t bookInboxCapacity = 256;
+// Instructions a worker matches on one book before it puts the book back and
+// picks again, so that a busy book cannot starve the quiet ones.
+constexpr size_t bookRunBudget = 256;
 
 // === Order Pool Configuration ===
-// A chunk size of 2^20 orders. 1,048,576 orders * 24 bytes/order = ~25MB per chunk.
-constexpr size_t orderPoolChunkSize = 1048576;
+// Books take order records from a shared SlabArena in slabs of 2^10 orders:
+// 1,024 orders * (16 hot + 8 cold) bytes/order = 24KB per slab. A book holds
+// no slab until its first order, and hands back every slab that empties
+// except the one it is filling.
+constexpr size_t orderSlabOrders = 1024;
+// The arena maps slabs from the OS this many at a time (6MB).
+constexpr size_t slabArenaRegionSlabs = 256;
+// Free slabs the arena keeps resident for reuse; any beyond that have their
+// memory returned to the OS and are faulted in again on reuse.
+constexpr size_t slabArenaWarmSlabs = 256;
+// Resting orders per book reserved and prefaulted when the engine starts.
+// 0 keeps an idle book's pool empty until its first order arrives.
+constexpr size_t orderPoolPrewarmOrders = 0;
+
+// === Input Journal Configuration ===
+// Instructions a journal buffers between its matching thread and its writer;
+// past that, a journal keeps them in an overflow buffer in memory.
+constexpr size_t journalRingRecords = 65536;
+// Group commit: the writer syncs once this many records are waiting for a
+// sync, or the oldest of them has waited journalCommitIntervalUs.
+constexpr size_t journalCommitBatch = 4096;
+constexpr uint64_t journalCommitIntervalUs = 1000;
+
+// === Snapshot Configuration ===
+// A SnapshotCapture copies the changed levels left once there are no more
+// than this many in a single step, over its order budget, and completes.
+constexpr size_t snapshotFinalLevels = 16;
 
 // === Data Generator Configuration ===
 const std::vector<std::string> tickers = {
@@ -35,7 +111,42 @@ constexpr int maxGenQty = 100;
 constexpr uint32_t initialOrderId = 1000;
 constexpr uint64_t initialTimestamp = 1694778123456789;
 
+// === Workload Model Configuration ===
+// Defaults of WorkloadModel (see WorkloadGenerator.h), used by GenerateData.
+// The same seed and model give the same instructions on every run with the
+// same math library (see WorkloadGenerator).
+constexpr uint64_t workloadSeed = 20250915;
+// 0 gives every ticker the same volume.
+constexpr double tickerZipfExponent = 1.0;
+// Chance per instruction that the ticker's mid moves a tick up or down.
+constexpr double midStepProbability = 0.002;
+// Passive orders rest on average this many ticks behind the mid.
+constexpr double passiveOffsetMean = 8.0;
+constexpr uint32_t maxPassiveOffset = 500;
+// Share of adds priced through the mid, on average this many ticks past it.
+constexpr double marketableRatio = 0.05;
+constexpr double marketableOffsetMean = 2.0;
+// Quantity tail: P(quantity > q) ~ q^-quantityTailIndex.
+constexpr double quantityTailIndex = 1.5;
+// Orders live an exponential number of instructions before their cancel:
+// fastCancelShare of them fastCancelMean on average, the rest slowCancelMean.
+constexpr double fastCancelShare = 0.5;
+constexpr double fastCancelMean = 20.0;
+constexpr double slowCancelMean = 1000.0;
+// Bursts: how often one starts on a ticker, how many instructions it lasts,
+// how much busier and more volatile the ticker gets, and how many of its
+// adds are marketable meanwhile.
+constexpr double burstStartProbability = 1.0 / 100'000;
+constexpr double burstLengthMean = 5000.0;
+constexpr double burstIntensity = 10.0;
+constexpr double burstMarketableRatio = 0.3;
+// Mean timestamp gap between instructions outside bursts.
+constexpr double meanArrivalGap = 1.0;
+
 // === Data Generation Distribution (as percentages) ===
+// WorkloadGenerator only uses the add and edit weights: its cancels follow
+// the order lifetimes above, which with these defaults make about 40% of
+// the instructions cancels.
 constexpr int addInstructionWeight = 60; // 60% ADD instructions
 constexpr int cancelInstructionWeight = 20; // 20% CANCEL instructions
 constexpr int editInstructionWeight = 20; // 20% EDIT instructions
@@ -47,8 +158,30 @@ constexpr double staleInstructionProbability = 1.0 / 50'000'000;
 
 // === Benchmark Configuration ===
 const std::string dataFileName = "orders.dat";
+// Per-ticker instruction files are <TICKER> + extension, in the text or the
+// binary format (see InstructionFile.h).
+const std::string textDataExtension = ".dat";
+const std::string binaryDataExtension = ".bin";
 constexpr int numInstructions = 1'000'000'000;
 constexpr int histogramBlockSize = 10'000'000;
+// Instructions decoded per processBatch call when replaying a ticker file,
+// unless the replay is given another depth (Benchmark's --batch_size,
+// ReplayJournal's --batch), which may be anything up to
+// maxInstructionBatchSize.
+constexpr size_t instructionBatchSize = 64;
+constexpr size_t maxInstructionBatchSize = 1024;
+// Decoded batches buffered between the parser and the matching thread.
+constexpr size_t parserRingBatches = 64;
+// Times every replayed instruction with the TSC into per-ticker, per-type
+// latency histograms and prints their percentiles after the run. Timed
+// replays run instructions one at a time, without processBatch's prefetch,
+// so leave it off for throughput numbers; -DORDERBOOK_LATENCY_HISTOGRAMS
+// turns it on without editing this file.
+#ifdef ORDERBOOK_LATENCY_HISTOGRAMS
+constexpr bool recordLatencyHistograms = true;
+#else
+constexpr bool recordLatencyHistograms = false;
+#endif
 
 } // namespace Config
 
@@ -0,0 +1,167 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef DIRECT_ID_TABLE_INCLUDED
+#define DIRECT_ID_TABLE_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Configuration.h"
+#include "Order.h"
+
+// Order ID -> pool index without hashing, for feeds whose IDs are dense and
+// mostly increasing (like GenerateData's id_counter). ID - baseId selects a
+// page in a directory and then a slot in the page. Pages are allocated on
+// first insert and freed once their last order is erased, and the directory
+// drops leading pages the feed has moved past. Same interface as FastMap.
+class DirectIdTable {
+private:
+  static constexpr size_t page_shift = Config::idTablePageShift;
+  static constexpr size_t page_slots = size_t{1} << page_shift;
+  static constexpr size_t page_mask = page_slots - 1;
+
+  struct Page {
+    Page() { slots.fill(nullOrder); }
+    std::array<OrderIndex, page_slots> slots;
+    uint32_t live = 0;
+  };
+
+  std::vector<std::unique_ptr<Page>> pages; // pages[0] covers IDs [base_id, base_id + page_slots)
+  uint32_t base_id = 0;
+  size_t leading_free = 0; // pages[0, leading_free) are known to be empty
+  size_t element_count = 0;
+  size_t resident_pages = 0;
+  std::unique_ptr<Page> spare_page; // Recycled instead of freeing the last page that emptied
+
+  // Directory entry for key, or nullptr if it lies outside the directory.
+  std::unique_ptr<Page>* slotPage(uint32_t key) {
+    if (key < base_id) return nullptr;
+    size_t page = static_cast<size_t>(key - base_id) >> page_shift;
+    return (page < pages.size()) ? &pages[page] : nullptr;
+  }
+
+  void extendTo(uint32_t key) {
+    if (pages.empty()) {
+      base_id = key & ~static_cast<uint32_t>(page_mask);
+      pages.resize(1);
+      leading_free = 1;
+      return;
+    }
+    if (key < base_id) {
+      size_t missing = ((base_id - key) + page_mask) >> page_shift;
+      std::vector<std::unique_ptr<Page>> grown(missing + pages.size());
+      std::move(pages.begin(), pages.end(), grown.begin() + missing);
+      pages = std::move(grown);
+      base_id -= static_cast<uint32_t>(missing << page_shift);
+      leading_free += missing;
+    } else {
+      pages.resize((static_cast<size_t>(key - base_id) >> page_shift) + 1);
+    }
+  }
+
+  void releasePage(std::unique_ptr<Page>& page) {
+    if (!spare_page) {
+      spare_page = std::move(page);
+    } else {
+      page.reset();
+    }
+    resident_pages--;
+
+    // Drop the run of empty pages at the front once it is most of the
+    // directory, so a steadily increasing feed keeps a bounded directory.
+    while (leading_free < pages.size() && !pages[leading_free]) leading_free++;
+    if (leading_free > 0 && leading_free * 2 >= pages.size()) {
+      pages.erase(pages.begin(), pages.begin() + leading_free);
+      base_id += static_cast<uint32_t>(leading_free << page_shift);
+      leading_free = 0;
+    }
+  }
+
+public:
+  DirectIdTable() = default;
+
+  // Reserves directory room for n consecutive IDs; pages are still lazy.
+  void reserve(size_t n) {
+    pages.reserve((n >> page_shift) + 1);
+  }
+
+  // Removes every entry and releases every page.
+  void clear() {
+    pages.clear();
+    leading_free = 0;
+    element_count = 0;
+    resident_pages = 0;
+  }
+
+  // Frees the spare page and unused directory room.
+  void shrinkToFit() {
+    spare_page.reset();
+    pages.shrink_to_fit();
+  }
+
+  size_t size() const { return element_count; }
+
+  // Bytes held by the directory and the resident pages.
+  size_t memoryUsage() const {
+    return pages.capacity() * sizeof(pages[0]) + (resident_pages + (spare_page ? 1 : 0)) * sizeof(Page);
+  }
+
+  // Inserts or overwrites the value for key. value must not be nullOrder.
+  void insert(uint32_t key, OrderIndex value) {
+    std::unique_ptr<Page>* page = slotPage(key);
+    if (page == nullptr) {
+      extendTo(key);
+      page = slotPage(key);
+    }
+    if (!*page) {
+      *page = spare_page ? std::move(spare_page) : std::make_unique<Page>();
+      resident_pages++;
+      leading_free = std::min(leading_free, static_cast<size_t>(page - pages.data()));
+    }
+    OrderIndex& slot = (*page)->slots[(key - base_id) & page_mask];
+    if (slot == nullOrder) {
+      (*page)->live++;
+      element_count++;
+    }
+    slot = value;
+  }
+
+  // Starts loading the slot of key ahead of a find or erase. The directory
+  // entry itself is read, which is cheap for the dense IDs this table is for.
+  void prefetch(uint32_t key) const {
+    if (key < base_id) return;
+    size_t page = static_cast<size_t>(key - base_id) >> page_shift;
+    if (page < pages.size() && pages[page]) {
+      __builtin_prefetch(&pages[page]->slots[(key - base_id) & page_mask]);
+    }
+  }
+
+  OrderIndex* find(uint32_t key) {
+    std::unique_ptr<Page>* page = slotPage(key);
+    if (page == nullptr || !*page) return nullptr;
+    OrderIndex& slot = (*page)->slots[(key - base_id) & page_mask];
+    return (slot != nullOrder) ? &slot : nullptr;
+  }
+
+  void erase(uint32_t key) {
+    std::unique_ptr<Page>* page = slotPage(key);
+    if (page == nullptr || !*page) return;
+    OrderIndex& slot = (*page)->slots[(key - base_id) & page_mask];
+    if (slot == nullOrder) return;
+    slot = nullOrder;
+    element_count--;
+    if (--(*page)->live == 0) {
+      releasePage(*page);
+    }
+  }
+};
+
+#endif // !DIRECT_ID_TABLE_INCLUDED
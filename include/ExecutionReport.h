@@ -0,0 +1,37 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef EXECUTION_REPORT_INCLUDED
+#define EXECUTION_REPORT_INCLUDED
+
+#include <cstdint>
+
+// One fill between an incoming order and a resting one, at the resting price.
+// Sequence numbers are per book and contiguous, so a gap tells the consumer
+// that reports were dropped while its ring was full.
+struct ExecutionReport {
+  uint64_t sequence;
+  uint32_t aggressorId;
+  uint32_t restingId;
+  uint32_t price;              // In ticks
+  uint32_t quantity;           // Filled by this execution
+  uint32_t aggressorRemaining; // Left on the incoming order after this fill
+  uint32_t restingRemaining;   // Left on the resting order; 0 means it is gone
+};
+
+static_assert(sizeof(ExecutionReport) == 32, "Two reports per cache line");
+
+// What happened to one incoming order. filled + resting + cancelled adds up
+// to the order's quantity; a rejected order is cancelled in full.
+struct ExecutionSummary {
+  uint32_t filledQuantity = 0;
+  uint32_t restingQuantity = 0;   // Added to the book
+  uint32_t cancelledQuantity = 0; // Discarded by the order type, or rejected
+  uint32_t fills = 0;
+};
+
+#endif // !EXECUTION_REPORT_INCLUDED
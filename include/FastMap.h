@@ -8,39 +8,48 @@
 #ifndef FAST_MAP_INCLUDED
 #define FAST_MAP_INCLUDED
 
+#include <algorithm>
+#include <bit>
 #include <vector>
 #include <cstdint>
 #include "Order.h"
 
 // A simple, open-addressing hash map inspired by the 1BRC solutions.
-// This is not a general-purpose hash map; it's tailored for this specific use case.
+// This is not a general-purpose hash map; it's tailored for this specific use case:
+// order ID -> pool index, where nullOrder is never stored and marks an empty slot.
+// Erase uses backward-shift deletion, so there are no tombstones and probe
+// chains only ever contain live entries, however long the add/cancel churn.
 class FastMap {
 private:
   struct Entry {
     uint32_t key;
-    Order* value;
-    enum class State { EMPTY, OCCUPIED, DELETED };
-    State state = State::EMPTY;
+    OrderIndex value = nullOrder;
   };
+  static_assert(sizeof(Entry) == 8, "Entries are packed key/value pairs");
 
   std::vector<Entry> table;
   size_t table_size;
   size_t element_count = 0;
 
-  size_t hash(uint32_t key) const {
+  static constexpr size_t initial_size = 64;
+
+  static size_t hash(uint32_t key, size_t mask) {
     key = ((key >> 16) ^ key) * 0x45d9f3b;
     key = ((key >> 16) ^ key) * 0x45d9f3b;
     key = (key >> 16) ^ key;
-    return key & (table_size - 1);
+    return key & mask;
   }
 
-  void resize() {
-    size_t new_size = table_size * 2;
+  size_t hash(uint32_t key) const {
+    return hash(key, table_size - 1);
+  }
+
+  void rehash(size_t new_size) {
     std::vector<Entry> new_table(new_size);
     for (const auto& entry : table) {
-      if (entry.state == Entry::State::OCCUPIED) {
-        size_t index = hash(entry.key);
-        while (new_table[index].state != Entry::State::EMPTY) {
+      if (entry.value != nullOrder) {
+        size_t index = hash(entry.key, new_size - 1);
+        while (new_table[index].value != nullOrder) {
           index = (index + 1) & (new_size - 1);
         }
         new_table[index] = entry;
@@ -51,42 +60,66 @@ private:
   }
 
 public:
-  FastMap() : table_size(1024) { // Initial size
+  FastMap() : table_size(initial_size) { // Initial size
     table.resize(table_size);
   }
 
-  Order*& operator[](uint32_t key) {
-    if (element_count * 2 > table_size) {
-      resize();
+  // Sizes the table so that n entries fit under the maximum load factor of 1/2.
+  void reserve(size_t n) {
+    size_t wanted = std::bit_ceil(n * 2);
+    if (wanted > table_size) {
+      rehash(wanted);
     }
+  }
 
-    size_t index = hash(key);
-    size_t tombstone_index = -1;
+  // Shrinks the table to the smallest size that keeps the load factor at or
+  // under 1/2, but not below the initial size.
+  void shrinkToFit() {
+    size_t wanted = std::max(initial_size, std::bit_ceil(std::max<size_t>(element_count, 1) * 2));
+    if (wanted < table_size) {
+      rehash(wanted);
+    }
+  }
 
-    while (table[index].state != Entry::State::EMPTY) {
-      if (table[index].state == Entry::State::OCCUPIED && table[index].key == key) {
-        return table[index].value;
-      }
-      if (table[index].state == Entry::State::DELETED && tombstone_index == (size_t)-1) {
-        tombstone_index = index;
-      }
-      index = (index + 1) & (table_size - 1);
+  // Removes every entry but keeps the table allocated.
+  void clear() {
+    std::fill(table.begin(), table.end(), Entry{});
+    element_count = 0;
+  }
+
+  size_t size() const { return element_count; }
+  size_t capacity() const { return table_size; }
+  size_t memoryUsage() const { return table.capacity() * sizeof(Entry); }
+
+  // Inserts or overwrites the value for key. value must not be nullOrder.
+  void insert(uint32_t key, OrderIndex value) {
+    if ((element_count + 1) * 2 > table_size) {
+      rehash(table_size * 2);
     }
 
-    if (tombstone_index != (size_t)-1) {
-      index = tombstone_index;
+    size_t index = hash(key);
+    while (table[index].value != nullOrder) {
+      if (table[index].key == key) {
+        table[index].value = value;
+        return;
+      }
+      index = (index + 1) & (table_size - 1);
     }
 
-    table[index].state = Entry::State::OCCUPIED;
     table[index].key = key;
+    table[index].value = value;
     element_count++;
-    return table[index].value;
   }
 
-  Order** find(uint32_t key) {
+  // Starts loading the home slot of key ahead of a find or erase.
+  void prefetch(uint32_t key) const {
+    __builtin_prefetch(&table[hash(key)]);
+  }
+
+  OrderIndex* find(uint32_t key) {
     size_t index = hash(key);
-    while (table[index].state != Entry::State::EMPTY) {
-      if (table[index].state == Entry::State::OCCUPIED && table[index].key == key) {
+    while (table[index].value != nullOrder) {
+      if (table[index].key == key) {
         return &table[index].value;
       }
       index = (index + 1) & (table_size - 1);
@@ -95,15 +128,32 @@ public:
   }
 
   void erase(uint32_t key) {
+    const size_t mask = table_size - 1;
     size_t index = hash(key);
-    while (table[index].state != Entry::State::EMPTY) {
-      if (table[index].state == Entry::State::OCCUPIED && table[index].key == key) {
-        table[index].state = Entry::State::DELETED;
-        element_count--;
-        return;
+    while (table[index].value != nullOrder) {
+      if (table[index].key == key) {
+        break;
       }
-      index = (index + 1) & (table_size - 1);
+      index = (index + 1) & mask;
+    }
+    if (table[index].value == nullOrder) {
+      return; // Not present
+    }
+    element_count--;
+
+    // Backward-shift: pull later entries of the probe chain into the hole
+    // unless that would move them in front of their home slot.
+    size_t hole = index;
+    size_t next = (hole + 1) & mask;
+    while (table[next].value != nullOrder) {
+      size_t home = hash(table[next].key);
+      if (((next - home) & mask) >= ((next - hole) & mask)) {
+        table[hole] = table[next];
+        hole = next;
+      }
+      next = (next + 1) & mask;
     }
+    table[hole].value = nullOrder;
   }
 };
 
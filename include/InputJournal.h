@@ -0,0 +1,145 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef INPUT_JOURNAL_INCLUDED
+#define INPUT_JOURNAL_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Configuration.h"
+#include "Instruction.h"
+#include "SpscRing.h"
+
+// Journal file: one JournalFileHeader followed by JournalRecords numbered
+// 1, 2, 3... in the order their instructions were matched, little-endian and
+// laid out as in memory. A crash can leave a torn or unwritten tail, so a
+// reader replays records up to the first one out of sequence (see
+// journalRecordCount). Bump version whenever a layout changes.
+struct JournalFileHeader {
+  static constexpr char expectedMagic[8] = {'O', 'B', 'S', 'J', 'R', 'N', 'L', '\0'};
+  static constexpr uint32_t currentVersion = 1;
+
+  char magic[8];
+  uint32_t version;
+  uint32_t recordSize;
+  uint32_t ticksPerUnit; // Price grid of the records
+  uint32_t shard;        // Which ShardedEngine shard wrote the journal
+  uint32_t shardCount;
+  uint32_t reserved;
+};
+
+struct JournalRecord {
+  uint64_t sequence;
+  Instruction instruction;
+};
+
+static_assert(sizeof(JournalFileHeader) == 32, "Header keeps records 8-byte aligned");
+static_assert(sizeof(JournalRecord) == 32, "Records are packed");
+
+// Whether a journal of fileSize bytes starting with header can be replayed
+// by this build.
+inline bool isValidJournalFile(const JournalFileHeader& header, size_t fileSize) {
+  return std::memcmp(header.magic, JournalFileHeader::expectedMagic, sizeof(header.magic)) == 0 &&
+         header.version == JournalFileHeader::currentVersion &&
+         header.recordSize == sizeof(JournalRecord) &&
+         header.ticksPerUnit == Config::ticksPerUnit &&
+         fileSize >= sizeof(JournalFileHeader);
+}
+
+// How many of the count records are intact: the run numbered 1, 2, 3...
+// from the first.
+inline size_t journalRecordCount(const JournalRecord* records, size_t count) {
+  size_t n = 0;
+  while (n < count && records[n].sequence == n + 1) ++n;
+  return n;
+}
+
+enum class JournalMode : uint8_t {
+  Async,      // Records are written as they come, and synced only by flush()
+  GroupCommit // Records are synced in groups, see Config::journalCommitBatch
+};
+
+// Write-ahead journal of one matching thread's input. append() only copies
+// instructions into a ring; a writer thread of the journal's own numbers
+// them, writes them out and, in GroupCommit mode, fdatasyncs once
+// commitBatch records are waiting or the oldest has waited commitIntervalUs,
+// so one sync covers a whole group. append() never waits: once the disk has
+// fallen Config::journalRingRecords behind, records queue in an overflow
+// buffer in memory, without bound, and go to the ring ahead of later ones
+// as it drains. Only flush() waits on the disk.
+class InputJournal {
+public:
+  // Creates path, which must not exist yet, so that an old journal is never
+  // overwritten before it has been replayed. shard and shardCount go into the
+  // header. Check ok() before use.
+  InputJournal(const std::string& path, JournalMode mode, uint32_t shard = 0, uint32_t shardCount = 1,
+               size_t commitBatch = Config::journalCommitBatch,
+               uint64_t commitIntervalUs = Config::journalCommitIntervalUs);
+  // Flushes, then stops the writer.
+  ~InputJournal();
+  InputJournal(const InputJournal&) = delete;
+  InputJournal& operator=(const InputJournal&) = delete;
+
+  // Whether the file was created and every write and sync so far succeeded.
+  // After a failure records are still taken, so matching goes on, but they
+  // are dropped and writtenSequence() and durableSequence() stop.
+  bool ok() const { return !failed.load(std::memory_order_relaxed); }
+
+  // Owning thread only. Hands batch to the writer, through the overflow
+  // buffer when the ring is full or records already wait there.
+  void append(std::span<const Instruction> batch) {
+    appended += batch.size();
+    if (overflow.empty() && ring.tryPushBatch(batch.data(), batch.size())) [[likely]] return;
+    appendOverflow(batch);
+  }
+
+  // Owning thread only. Blocks until every appended record is written and
+  // synced.
+  void flush();
+
+  uint64_t appendedSequence() const { return appended; } // Owning thread only
+  // Owning thread only: batches that went through the overflow buffer, and
+  // records waiting there now.
+  uint64_t overflowedBatches() const { return overflowed; }
+  size_t overflowRecords() const { return overflow.size() - overflowHead; }
+  // Highest sequence handed to the OS, which survives a crash of the process.
+  uint64_t writtenSequence() const { return written.load(std::memory_order_acquire); }
+  // Highest sequence synced to disk, which survives a crash of the machine.
+  uint64_t durableSequence() const { return durable.load(std::memory_order_acquire); }
+  uint64_t syncs() const { return syncCount.load(std::memory_order_relaxed); }
+
+private:
+  void run();
+  [[gnu::noinline]] void appendOverflow(std::span<const Instruction> batch);
+  // Moves what the ring has room for; returns true once nothing is left.
+  bool drainOverflow();
+
+  const JournalMode mode;
+  const size_t commitBatch;
+  const uint64_t commitIntervalNs;
+  int fd = -1;
+  SpscRing<Instruction> ring;
+  uint64_t appended = 0;
+  std::vector<Instruction> overflow; // Owning thread only; from overflowHead on
+  size_t overflowHead = 0;
+  uint64_t overflowed = 0;
+  std::atomic<uint64_t> flushRequested{0}; // Sync everything up to this now
+  std::atomic<uint64_t> written{0};
+  std::atomic<uint64_t> durable{0};
+  std::atomic<uint64_t> syncCount{0};
+  std::atomic<bool> failed{false};
+  std::atomic<bool> running{true};
+  std::thread writer;
+};
+
+#endif // !INPUT_JOURNAL_INCLUDED
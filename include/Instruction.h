@@ -0,0 +1,52 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef INSTRUCTION_INCLUDED
+#define INSTRUCTION_INCLUDED
+
+#include <cstdint>
+#include "Order.h"
+#include "ExecutionReport.h"
+
+enum class InstructionAction : uint8_t {
+  Add,
+  Cancel,
+  Edit
+};
+
+// One decoded instruction of the feed, as taken by MatchingEngine::processBatch.
+struct Instruction {
+  uint64_t timestamp;
+  uint32_t ID;
+  uint32_t price;    // In ticks
+  uint32_t quantity;
+  uint16_t tickerId;
+  InstructionAction action;
+  uint8_t flags;     // buyFlag | OrderType
+
+  static constexpr uint8_t buyFlag = 0x80;
+  static constexpr uint8_t typeMask = 0x0f;
+
+  bool isBuy() const { return (flags & buyFlag) != 0; }
+  OrderType orderType() const { return static_cast<OrderType>(flags & typeMask); }
+
+  static uint8_t makeFlags(bool isBuy, OrderType type = OrderType::Limit) {
+    return static_cast<uint8_t>((isBuy ? buyFlag : 0) | static_cast<uint8_t>(type));
+  }
+};
+
+static_assert(sizeof(Instruction) == 24, "Instructions are packed 24-byte records");
+
+// Outcome of one Instruction. accepted is false for an unknown ticker and for
+// a cancel or edit of an order that is not in the book; summary is only set
+// for adds.
+struct InstructionResult {
+  ExecutionSummary summary;
+  bool accepted;
+};
+
+#endif // !INSTRUCTION_INCLUDED
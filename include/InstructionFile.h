@@ -0,0 +1,62 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef INSTRUCTION_FILE_INCLUDED
+#define INSTRUCTION_FILE_INCLUDED
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include "Configuration.h"
+#include "Instruction.h"
+
+// Binary instruction file: one InstructionFileHeader followed by recordCount
+// Instruction records, little-endian, exactly as they sit in memory, so a
+// replay can mmap the file and hand the records to processBatch unparsed.
+// Bump version whenever the Instruction layout changes.
+struct InstructionFileHeader {
+  static constexpr char expectedMagic[8] = {'O', 'B', 'S', 'I', 'N', 'S', 'T', '\0'};
+  static constexpr uint32_t currentVersion = 1;
+
+  char magic[8];
+  uint32_t version;
+  uint32_t recordSize;
+  uint64_t recordCount;
+  uint32_t ticksPerUnit; // Price grid of the records
+  uint32_t reserved;
+};
+
+static_assert(sizeof(InstructionFileHeader) == 32, "Header keeps records 8-byte aligned");
+
+inline InstructionFileHeader makeInstructionFileHeader(uint64_t recordCount) {
+  InstructionFileHeader header{};
+  std::memcpy(header.magic, InstructionFileHeader::expectedMagic, sizeof(header.magic));
+  header.version = InstructionFileHeader::currentVersion;
+  header.recordSize = sizeof(Instruction);
+  header.recordCount = recordCount;
+  header.ticksPerUnit = Config::ticksPerUnit;
+  return header;
+}
+
+// Whether a file of fileSize bytes starting with header can be replayed by
+// this build.
+inline bool isValidInstructionFile(const InstructionFileHeader& header, size_t fileSize) {
+  return std::memcmp(header.magic, InstructionFileHeader::expectedMagic, sizeof(header.magic)) == 0 &&
+         header.version == InstructionFileHeader::currentVersion &&
+         header.recordSize == sizeof(Instruction) &&
+         header.ticksPerUnit == Config::ticksPerUnit &&
+         fileSize >= sizeof(InstructionFileHeader) + header.recordCount * sizeof(Instruction);
+}
+
+// Writes a header for recordCount records at the current position of out.
+// Writers that do not know the count up front write 0 and rewrite it at offset 0.
+inline void writeInstructionFileHeader(std::ostream& out, uint64_t recordCount) {
+  InstructionFileHeader header = makeInstructionFileHeader(recordCount);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+#endif // !INSTRUCTION_FILE_INCLUDED
@@ -0,0 +1,163 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef INSTRUCTION_PARSER_INCLUDED
+#define INSTRUCTION_PARSER_INCLUDED
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "Configuration.h"
+#include "Instruction.h"
+#include "Price.h"
+
+// Scalar decoder for the text feed written by GenerateData, one line per
+// instruction:
+//   ID;TICKER;SIDE;PRICE;QTY;TYPE;TIMESTAMP\n
+// SIDE is B or S, TYPE one of A (limit add), I (IOC), F (fill-or-kill),
+// M (market), P (post-only), C (cancel) or E (edit).
+
+// Custom fast parser for positive integers
+inline const char* fast_atoi(const char* p, uint32_t& out) {
+  out = 0;
+  while (*p >= '0' && *p <= '9') {
+    out = out * 10 + (*p++ - '0');
+  }
+  return p;
+}
+
+inline const char* fast_atoi64(const char* p, uint64_t& out) {
+  out = 0;
+  while (*p >= '0' && *p <= '9') {
+    out = out * 10 + (*p++ - '0');
+  }
+  return p;
+}
+
+// Narrows a parsed price to ticks; prices the book cannot hold become
+// invalidPriceTicks, which it rejects, instead of wrapping into range.
+inline uint32_t checkedTicks(uint64_t ticks) {
+  return ticks < Config::maxPriceTicks ? static_cast<uint32_t>(ticks) : invalidPriceTicks;
+}
+
+// Custom fast parser for decimal prices, producing integer ticks directly.
+// Fraction digits beyond what fits in the accumulator are ignored.
+inline const char* fast_atoticks(const char* p, uint32_t& out) {
+  uint64_t whole = 0;
+  uint64_t frac = 0;
+  uint64_t scale = 1;
+  while (*p >= '0' && *p <= '9') {
+    if (whole < Config::maxPriceTicks) { // Out of range already; stop before it can wrap
+      whole = whole * 10 + (*p - '0');
+    }
+    p++;
+  }
+  if (*p == '.') {
+    p++;
+    while (*p >= '0' && *p <= '9') {
+      if (scale < 1'000'000'000) {
+        frac = frac * 10 + (*p - '0');
+        scale *= 10;
+      }
+      p++;
+    }
+  }
+  // Round the fraction to the nearest tick
+  out = checkedTicks(whole * Config::ticksPerUnit + (frac * Config::ticksPerUnit + scale / 2) / scale);
+  return p;
+}
+
+// Action and order type of each TYPE character, looked up rather than
+// switched on since the feed mixes types with no pattern to predict.
+struct InstructionType {
+  InstructionAction action;
+  OrderType orderType;
+  bool valid;
+};
+
+inline constexpr std::array<InstructionType, 256> instructionTypes = []() {
+  std::array<InstructionType, 256> table{};
+  table['A'] = {InstructionAction::Add, OrderType::Limit, true};
+  table['I'] = {InstructionAction::Add, OrderType::ImmediateOrCancel, true};
+  table['F'] = {InstructionAction::Add, OrderType::FillOrKill, true};
+  table['M'] = {InstructionAction::Add, OrderType::Market, true};
+  table['P'] = {InstructionAction::Add, OrderType::PostOnly, true};
+  table['C'] = {InstructionAction::Cancel, OrderType::Limit, true};
+  table['E'] = {InstructionAction::Edit, OrderType::Limit, true};
+  return table;
+}();
+
+// Sets action and flags of out from the TYPE and SIDE characters. Returns
+// false for an unknown instruction type.
+inline bool setInstructionType(char type, bool isBuy, Instruction& out) {
+  const InstructionType& entry = instructionTypes[static_cast<uint8_t>(type)];
+  out.action = entry.action;
+  out.flags = Instruction::makeFlags(isBuy, entry.orderType);
+  return entry.valid;
+}
+
+// Decodes the line at p into out and advances p to the next line. Returns
+// false, with the line still consumed, for an unknown instruction type.
+inline bool parseInstructionLine(const char*& p, const char* end, uint16_t tickerId, Instruction& out) {
+  uint32_t id, qty, price;
+  uint64_t timestamp;
+
+  p = fast_atoi(p, id);
+  p++; // Skip ';'
+
+  while (*p != ';') p++; // Skip ticker
+  p++; // Skip ';'
+
+  const bool isBuy = *p == 'B';
+  p += 2; // Skip side and ';'
+
+  p = fast_atoticks(p, price);
+  p++; // Skip ';'
+
+  p = fast_atoi(p, qty);
+  p++; // Skip ';'
+
+  const char type = *p;
+  p += 2; // Skip type and ';'
+
+  p = fast_atoi64(p, timestamp);
+  while (p < end && *p != '\n') p++;
+  if (p < end) p++; // Skip newline, absent on the last line of some files
+
+  out = {timestamp, id, price, qty, tickerId, InstructionAction::Add, 0};
+  return setInstructionType(type, isBuy, out);
+}
+
+// Bulk decoder (src/InstructionParser.cpp). The ';' and '\n' of a 64-byte
+// block are located with vector compares, then the line's numeric fields are
+// decoded eight digits at a time knowing their lengths. Lines that do not
+// have the expected shape, and the Scalar implementation, go through
+// parseInstructionLine.
+enum class ParserIsa : uint8_t {
+  Scalar,
+  Sse42,
+  Avx2
+};
+
+// Fastest implementation the running CPU supports.
+ParserIsa detectParserIsa();
+const char* parserIsaName(ParserIsa isa);
+
+// Decodes up to maxOut instructions from [p, end) into out and advances p
+// past the lines consumed. isa must be supported by the running CPU. Lines
+// with an unknown type are consumed and counted in skipped. Returns the
+// number of instructions written.
+size_t parseInstructions(ParserIsa isa, const char*& p, const char* end, uint16_t tickerId,
+                         Instruction* out, size_t maxOut, size_t& skipped);
+
+inline size_t parseInstructions(const char*& p, const char* end, uint16_t tickerId,
+                                Instruction* out, size_t maxOut, size_t& skipped) {
+  static const ParserIsa isa = detectParserIsa();
+  return parseInstructions(isa, p, end, tickerId, out, maxOut, skipped);
+}
+
+#endif // !INSTRUCTION_PARSER_INCLUDED
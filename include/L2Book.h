@@ -0,0 +1,43 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef L2_BOOK_INCLUDED
+#define L2_BOOK_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+
+#include "LevelUpdate.h"
+
+// Consumer side of a book's level updates: an L2 copy of the book, on
+// whichever thread polls its ring. It starts out in step with an empty book.
+// Once an update is missing, the copy is stale and ignores updates until
+// resync() hands it a DepthSnapshot of the book.
+class L2Book {
+public:
+  // Returns false if the copy is stale, now or already.
+  bool apply(const LevelUpdate& update);
+  // Replaces the copy by snapshot. Updates the snapshot reflects already
+  // are skipped afterwards.
+  void resync(const DepthSnapshot& snapshot);
+
+  bool stale() const { return isStale; }
+  // Sequence of the next update the copy expects.
+  uint64_t nextSequence() const { return expected; }
+  // Same as OrderBook::getDepth.
+  size_t getDepth(bool isBuy, size_t nLevels, DepthLevel* out) const;
+
+private:
+  std::map<uint32_t, DepthLevel, std::greater<uint32_t>> bids; // Best first
+  std::map<uint32_t, DepthLevel> asks;
+  uint64_t expected = 0;
+  bool isStale = false;
+};
+
+#endif // !L2_BOOK_INCLUDED
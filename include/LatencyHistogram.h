@@ -0,0 +1,84 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef LATENCY_HISTOGRAM_INCLUDED
+#define LATENCY_HISTOGRAM_INCLUDED
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Log-bucketed histogram in the style of HdrHistogram: every power of two is
+// split into subBuckets linear buckets, so any recorded value is known to
+// within 1 / subBuckets (about 3%) from 1 to 2^maxBits - 1, in constant
+// memory and with one bit scan per record. Values below 2 * subBuckets are
+// exact; larger ones than the range count in the top bucket. Units are the
+// caller's, e.g. TSC ticks.
+class LatencyHistogram {
+public:
+  static constexpr unsigned subBucketBits = 5;
+  static constexpr uint64_t subBuckets = uint64_t{1} << subBucketBits;
+  static constexpr unsigned maxBits = 40;
+  static constexpr size_t bucketCount = (maxBits - subBucketBits + 1) * subBuckets;
+
+  LatencyHistogram() : counts(bucketCount) {}
+
+  void record(uint64_t value) {
+    counts[bucketOf(value)]++;
+    total++;
+    maxValue = std::max(maxValue, value);
+  }
+
+  // Adds the samples of other, e.g. to combine the histograms of threads.
+  void merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < bucketCount; ++i) counts[i] += other.counts[i];
+    total += other.total;
+    maxValue = std::max(maxValue, other.maxValue);
+  }
+
+  uint64_t count() const { return total; }
+  uint64_t max() const { return maxValue; }
+
+  // Upper bound of the bucket holding the sample at percentile, capped at
+  // max(); max() itself beyond the tracked range. 0 when empty.
+  uint64_t valueAtPercentile(double percentile) const {
+    if (total == 0) return 0;
+    const double wanted = percentile / 100.0 * static_cast<double>(total);
+    uint64_t rank = static_cast<uint64_t>(wanted);
+    if (static_cast<double>(rank) < wanted || rank == 0) rank++; // ceil, at least one sample
+    uint64_t seen = 0;
+    for (size_t i = 0; i < bucketCount; ++i) {
+      seen += counts[i];
+      if (seen >= rank) return (i == bucketCount - 1) ? maxValue : std::min(upperBound(i), maxValue);
+    }
+    return maxValue;
+  }
+
+private:
+  static size_t bucketOf(uint64_t value) {
+    if (value < 2 * subBuckets) return static_cast<size_t>(value);
+    const unsigned shift = static_cast<unsigned>(std::bit_width(value)) - subBucketBits - 1;
+    const size_t bucket = (shift + 1) * subBuckets + ((value >> shift) - subBuckets);
+    return std::min(bucket, bucketCount - 1);
+  }
+
+  // Largest value that lands in bucket.
+  static uint64_t upperBound(size_t bucket) {
+    if (bucket < 2 * subBuckets) return bucket;
+    const unsigned shift = static_cast<unsigned>(bucket / subBuckets) - 1;
+    const uint64_t base = (subBuckets + bucket % subBuckets) << shift;
+    return base + (uint64_t{1} << shift) - 1;
+  }
+
+  std::vector<uint64_t> counts;
+  uint64_t total = 0;
+  uint64_t maxValue = 0;
+};
+
+#endif // !LATENCY_HISTOGRAM_INCLUDED
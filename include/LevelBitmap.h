@@ -0,0 +1,119 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef LEVEL_BITMAP_INCLUDED
+#define LEVEL_BITMAP_INCLUDED
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Hierarchical occupancy bitmap over the price levels of one side of the book.
+// Level 0 holds one bit per price level, every level above holds one bit per
+// non-zero word of the level below, up to a single root word. Finding the next
+// occupied level is one count-trailing/leading-zeros per level, so a ladder of
+// 2^24 levels costs at most four word lookups on the way up and four on the way down.
+class LevelBitmap {
+public:
+  static constexpr size_t npos = static_cast<size_t>(-1);
+
+  explicit LevelBitmap(size_t size = 0) { resize(size); }
+
+  // Resizing clears every bit.
+  void resize(size_t size) {
+    bitCount = size;
+    levels.clear();
+    size_t bits = size;
+    do {
+      size_t words = (bits + 63) / 64;
+      if (words == 0) words = 1;
+      levels.emplace_back(words, 0);
+      bits = words;
+    } while (bits > 1);
+  }
+
+  size_t size() const { return bitCount; }
+
+  bool test(size_t index) const {
+    return (levels[0][index >> 6] >> (index & 63)) & 1;
+  }
+
+  void set(size_t index) {
+    for (auto& words : levels) {
+      uint64_t& word = words[index >> 6];
+      bool wasEmpty = word == 0;
+      word |= uint64_t{1} << (index & 63);
+      if (!wasEmpty) return; // Upper levels already know about this word
+      index >>= 6;
+    }
+  }
+
+  void clear(size_t index) {
+    for (auto& words : levels) {
+      uint64_t& word = words[index >> 6];
+      word &= ~(uint64_t{1} << (index & 63));
+      if (word != 0) return; // Word still occupied, upper levels unchanged
+      index >>= 6;
+    }
+  }
+
+  // Lowest set index >= pos, or npos.
+  size_t findNextSet(size_t pos) const {
+    size_t level = 0;
+    for (;; ++level) {
+      if (level == levels.size()) return npos;
+      const auto& words = levels[level];
+      size_t word = pos >> 6;
+      if (word >= words.size()) return npos;
+      uint64_t bits = words[word] & (~uint64_t{0} << (pos & 63));
+      if (bits) {
+        pos = (word << 6) | std::countr_zero(bits);
+        break;
+      }
+      pos = word + 1;
+    }
+    while (level > 0) {
+      --level;
+      pos = (pos << 6) | std::countr_zero(levels[level][pos]);
+    }
+    return pos;
+  }
+
+  // Highest set index <= pos, or npos.
+  size_t findPrevSet(size_t pos) const {
+    if (bitCount == 0) return npos;
+    if (pos >= bitCount) pos = bitCount - 1;
+    size_t level = 0;
+    for (;; ++level) {
+      if (level == levels.size()) return npos;
+      size_t word = pos >> 6;
+      uint64_t bits = levels[level][word] & (~uint64_t{0} >> (63 - (pos & 63)));
+      if (bits) {
+        pos = (word << 6) | (63 - std::countl_zero(bits));
+        break;
+      }
+      if (word == 0) return npos;
+      pos = word - 1;
+    }
+    while (level > 0) {
+      --level;
+      pos = (pos << 6) | (63 - std::countl_zero(levels[level][pos]));
+    }
+    return pos;
+  }
+
+  size_t findFirst() const { return findNextSet(0); }
+  size_t findLast() const { return findPrevSet(bitCount); }
+  bool empty() const { return levels.back()[0] == 0; }
+
+private:
+  std::vector<std::vector<uint64_t>> levels; // levels[0] is one bit per price level
+  size_t bitCount = 0;
+};
+
+#endif // !LEVEL_BITMAP_INCLUDED
@@ -0,0 +1,58 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef LEVEL_UPDATE_INCLUDED
+#define LEVEL_UPDATE_INCLUDED
+
+#include <cstdint>
+#include <vector>
+
+#include "PriceLevel.h"
+
+// The new state of one price level of a book: an L2 delta. Updates carry
+// absolute values, so applying one twice does no harm; orderCount 0 means
+// the level is gone. Sequence numbers are per book and contiguous, so a gap
+// tells the consumer that updates were dropped while its ring was full.
+struct LevelUpdate {
+  uint64_t sequence;
+  uint64_t quantity; // Resting at the level
+  uint32_t price;    // In ticks
+  uint32_t orderCount;
+  bool isBuy;
+};
+
+static_assert(sizeof(LevelUpdate) == 32, "Two updates per cache line");
+
+enum class LevelUpdateMode : uint8_t {
+  Off,
+  EveryChange, // One update per change, as it happens
+  Conflated    // One update per changed level, see OrderBook::publishLevelUpdates
+};
+
+// Every occupied level of a book, best first, for a consumer to start from
+// or to resynchronise with. It reflects every update before sequence; later
+// updates are to be applied on top.
+struct DepthSnapshot {
+  std::vector<DepthLevel> bids;
+  std::vector<DepthLevel> asks;
+  uint64_t sequence = 0;
+};
+
+// Best bid and ask of a book and what rests there (see
+// MatchingEngine::getBBO). A side without orders is all zeros.
+struct TopOfBook {
+  uint64_t bidQuantity = 0;
+  uint64_t askQuantity = 0;
+  uint32_t bidPrice = 0; // In ticks
+  uint32_t askPrice = 0;
+  uint32_t bidOrders = 0;
+  uint32_t askOrders = 0;
+
+  bool operator==(const TopOfBook&) const = default;
+};
+
+#endif // !LEVEL_UPDATE_INCLUDED
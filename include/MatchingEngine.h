@@ -10,22 +10,86 @@
 #define MATCHING_ENGINE_INCLUDED
 
 #include "OrderBook.h"
+#include "Instruction.h"
+#include <span>
 #include <string>
 #include <memory> // Required for std::unique_ptr
 #include <vector>
 
 class MatchingEngine {
 private:
+  SlabArena arena; // Declared first: outlives the books holding its slabs
   std::vector<std::unique_ptr<OrderBook>> orderBooks;
   std::vector<std::string> tickerIdToNameMap;
 
+  InstructionResult execute(const Instruction& instruction);
+
 public:
+  // One book per Config::tickers entry.
   MatchingEngine();
-  void processOrders(uint32_t tickerId, bool isBuy, double price, uint32_t quantity, uint32_t timestamp, uint32_t ID);
+  // bookCount books with tickerIds 0 .. bookCount - 1, for instrument sets
+  // that are not listed in the configuration.
+  explicit MatchingEngine(size_t bookCount);
+
+  // Adds a book and returns its tickerId, the next unused one. Books start
+  // empty and take memory only as orders arrive. Not safe while other threads
+  // are running instructions through the engine, so register tickers before
+  // handing it to a ShardedEngine or BookScheduler.
+  uint32_t addTicker(const std::string& tickerName);
+  // Prices are integer ticks (see Price.h). Fills are also published to the
+  // book's execution report ring.
+  ExecutionSummary processOrders(uint32_t tickerId, bool isBuy, uint32_t price, uint32_t quantity, uint32_t timestamp, uint32_t ID);
+  // Any order type; the plain overload above is the limit order path.
+  ExecutionSummary processOrders(uint32_t tickerId, OrderType type, bool isBuy, uint32_t price, uint32_t quantity, uint32_t timestamp, uint32_t ID);
   bool cancelOrder(uint32_t tickerId, uint32_t ID);
-  bool editOrder(uint32_t tickerId, uint32_t ID, double newPrice, uint32_t newQuantity);
+  bool editOrder(uint32_t tickerId, uint32_t ID, uint32_t newPrice, uint32_t newQuantity);
+
+  // Convenience entry points taking decimal prices, rounded to the nearest
+  // tick. Named apart from the tick overloads so that integer literals are
+  // not ambiguous between the two.
+  ExecutionSummary processOrdersAtPrice(uint32_t tickerId, bool isBuy, double price, uint32_t quantity, uint32_t timestamp, uint32_t ID);
+  bool editOrderAtPrice(uint32_t tickerId, uint32_t ID, double newPrice, uint32_t newQuantity);
+  // Runs instructions in order, writing one result per instruction. Cancels
+  // and edits further down the batch are prefetched so that their cache
+  // misses overlap. Returns min(batch.size(), results.size()), the number run.
+  size_t processBatch(std::span<const Instruction> batch, std::span<InstructionResult> results);
+
+  size_t bookCount() const { return orderBooks.size(); }
+  // Bytes held by one book, see OrderBook::memoryUsage.
+  size_t bookMemoryUsage(uint32_t tickerId) const;
+  // The slabs of every book come from here.
+  const SlabArena& slabArena() const { return arena; }
+  // Lets every book return what it keeps for its next burst.
+  void shrinkToFit();
   void setTickerName(uint32_t tickerId, const std::string& tickerName);
   const OrderBook* getOrderBook(uint32_t tickerId) const;
+  // Pops up to maxReports execution reports of one book into out. Only one
+  // thread may poll a given ticker.
+  size_t pollExecutionReports(uint32_t tickerId, ExecutionReport* out, size_t maxReports);
+  // Pops up to maxUpdates level updates of one book into out. Only one
+  // thread may poll a given ticker; see L2Book for keeping a copy with them.
+  size_t pollLevelUpdates(uint32_t tickerId, LevelUpdate* out, size_t maxUpdates);
+  // Updates waiting in the book's ring; approximate while the book runs.
+  size_t pendingLevelUpdates(uint32_t tickerId) const;
+  void setLevelUpdateMode(uint32_t tickerId, LevelUpdateMode mode);
+  // For a consumer to resynchronise with; same thread rules as processBatch.
+  DepthSnapshot depthSnapshot(uint32_t tickerId);
+  size_t getDepth(uint32_t tickerId, bool isBuy, size_t nLevels, DepthLevel* out) const;
+  // Best bid and ask of a book with their sizes, from any thread and without
+  // locks, as of the end of the book's last operation or processBatch. The
+  // book's thread is never held up by readers. Tickers must not be added
+  // meanwhile (see addTicker).
+  TopOfBook getBBO(uint32_t tickerId) const;
+  // Snapshots every book into one file (see BookSnapshot.h), written by up
+  // to threads threads. No other thread may run instructions meanwhile; a
+  // worker that owns its books captures them with SnapshotCapture instead.
+  bool writeSnapshot(const std::string& path, size_t threads = 0);
+  // Maps a snapshot file and restores its sections in parallel, into books
+  // that must be empty; books and names are added for tickerIds the engine
+  // does not have yet. Returns false if the file is unreadable, was written
+  // for another price grid or is malformed, in which case books restored
+  // before the failure keep their orders.
+  bool restoreSnapshot(const std::string& path, size_t threads = 0);
   void printAllHistograms(int blockSize) const;
 };
 #endif // !MATCHING_ENGINE_INCLUDED
@@ -0,0 +1,96 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef MPSC_RING_INCLUDED
+#define MPSC_RING_INCLUDED
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Bounded lock-free ring for any number of producer threads and one consumer
+// thread. Every slot carries a sequence number: producers claim a position
+// with one compare-and-swap on tail, fill the slot and then publish it by
+// advancing its sequence, so the consumer never sees a half-written item and
+// a slow producer only holds back the items queued behind its own.
+template <class T>
+class MpscRing {
+public:
+  // capacity is rounded up to a power of two.
+  explicit MpscRing(size_t capacity)
+    : mask(std::bit_ceil(capacity < 2 ? size_t{2} : capacity) - 1),
+      slots(std::make_unique<Slot[]>(mask + 1)) {
+    for (size_t i = 0; i <= mask; ++i) {
+      slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpscRing(const MpscRing&) = delete;
+  MpscRing& operator=(const MpscRing&) = delete;
+
+  size_t capacity() const { return mask + 1; }
+
+  // Producer side, from any thread. Returns false, leaving the ring
+  // untouched, when it is full.
+  bool tryPush(const T& item) {
+    uint64_t t = tail.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot& slot = slots[t & mask];
+      const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+      if (sequence == t) {
+        if (tail.compare_exchange_weak(t, t + 1, std::memory_order_relaxed)) {
+          slot.item = item;
+          slot.sequence.store(t + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (sequence < t) {
+        return false; // The consumer has not freed this slot yet
+      } else {
+        t = tail.load(std::memory_order_relaxed); // Another producer got there first
+      }
+    }
+  }
+
+  // Consumer side. Pops up to maxItems published items into out, stopping at
+  // the first slot still being written, and returns how many.
+  size_t popBatch(T* out, size_t maxItems) {
+    const uint64_t h = head.load(std::memory_order_relaxed);
+    size_t n = 0;
+    for (; n < maxItems; ++n) {
+      Slot& slot = slots[(h + n) & mask];
+      if (slot.sequence.load(std::memory_order_acquire) != h + n + 1) break;
+      out[n] = slot.item;
+      slot.sequence.store(h + n + mask + 1, std::memory_order_release);
+    }
+    head.store(h + n, std::memory_order_relaxed);
+    return n;
+  }
+
+  // Approximate when called concurrently with either side.
+  size_t size() const {
+    const uint64_t h = head.load(std::memory_order_acquire); // Before tail, so never past it
+    return static_cast<size_t>(tail.load(std::memory_order_acquire) - h);
+  }
+
+private:
+  static constexpr size_t cacheLine = 64;
+
+  struct Slot {
+    std::atomic<uint64_t> sequence;
+    T item;
+  };
+
+  const size_t mask;
+  const std::unique_ptr<Slot[]> slots;
+
+  alignas(cacheLine) std::atomic<uint64_t> tail{0}; // Claimed by producers
+  alignas(cacheLine) std::atomic<uint64_t> head{0}; // Written by the consumer, read by size()
+};
+
+#endif // !MPSC_RING_INCLUDED
@@ -11,19 +11,39 @@
 
 #include <cstdint>
 
-struct Order {
-  double price;      // 8 bytes
-  uint32_t ID;       // 4 bytes
-  uint32_t tickerId;   // 4 bytes
-  uint32_t timestamp;// 4 bytes
-  uint32_t quantity; // 4 bytes
-  bool isBuy;        // 1 byte
+// Orders are addressed by their index in the OrderPool; links are indices too.
+using OrderIndex = uint32_t;
+constexpr OrderIndex nullOrder = UINT32_MAX;
+
+// How an incoming order treats the quantity it cannot fill right away.
+enum class OrderType : uint8_t {
+  Limit,             // Rests the remainder at its price
+  ImmediateOrCancel, // Fills what it can at its price or better, cancels the rest
+  FillOrKill,        // Fills entirely at its price or better, or not at all
+  Market,            // Fills what it can at any price, cancels the rest
+  PostOnly           // Rests entirely, or is rejected if it would cross
+};
 
-  // Pointers for doubly-linked list
-  Order* next = nullptr;
-  Order* prev = nullptr;
+// Hot part of a resting order, i.e. everything the matching sweep and the
+// level lists touch. Four orders share a cache line.
+struct Order {
+  // Indices for doubly-linked list; next also chains the pool's free slots
+  OrderIndex next = nullOrder; // 4 bytes
+  OrderIndex prev = nullOrder; // 4 bytes
+  uint32_t quantity;           // 4 bytes
+  uint32_t price : 31;         // 4 bytes with isBuy, in ticks
+  uint32_t isBuy : 1;
 
   Order() = default;
-}; 
+};
+
+// Cold attributes, stored in an array parallel to the Order array and
+// addressed by the same pool index. The ticker is implied by the owning book.
+struct OrderInfo {
+  uint32_t ID;        // 4 bytes
+  uint32_t timestamp; // 4 bytes
+};
+
+static_assert(sizeof(Order) == 16, "Order must stay at four per cache line");
 
 #endif // !ORDER_INCLUDED
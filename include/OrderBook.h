@@ -5,55 +5,212 @@
 //                                                                               //
 // ----------------------------------------------------------------------------- //
 
+#ifndef ORDER_BOOK_INCLUDED
+#define ORDER_BOOK_INCLUDED
 
 #include "Order.h"
 #include "OrderPool.h"
 #include "Configuration.h"
 #include "FastMap.h"
+#include "DirectIdTable.h"
+#include "PriceLadder.h"
+#include "PriceLevel.h"
+#include "ExecutionReport.h"
+#include "LevelUpdate.h"
+#include "SpscRing.h"
+#include "SeqLock.h"
+#include "BookSnapshot.h"
 #include <vector>
-#include <cmath>
 #include <string>
 
 class TestOrderBook;
 
+// The order ID index is picked at compile time. FastMap hashes any ID;
+// DirectIdTable (-DORDERBOOK_DIRECT_ID_INDEX) indexes dense, mostly increasing
+// IDs directly and skips the hashing and probing.
+#ifdef ORDERBOOK_DIRECT_ID_INDEX
+using OrderIdIndex = DirectIdTable;
+#else
+using OrderIdIndex = FastMap;
+#endif
+
 class OrderBook {
 private:
   OrderPool orderPool;
-  std::vector<Order*> BuyHeads; // Head of the doubly-linked list for buy orders at each price level
-  std::vector<Order*> BuyTails; // Tail of the doubly-linked list for buy orders at each price level
-  std::vector<Order*> SellHeads; // Head of the doubly-linked list for sell orders at each price level
-  std::vector<Order*> SellTails; // Tail of the doubly-linked list for sell orders at each price level
-  FastMap orderMap;
+  PriceLadder BuyLevels; // Queue and aggregates of buy orders at each price level
+  PriceLadder SellLevels; // Queue and aggregates of sell orders at each price level
+  OrderIdIndex orderMap;
 
   int bestBidIndex = -1;
   int bestAskIndex = -1;
 
-  size_t priceToIndex(double price) const {
-    return static_cast<size_t>(std::round((price - Config::minPrice) / Config::tickSize));
+  SpscRing<ExecutionReport> reports;
+  uint64_t reportSequence = 0;
+  uint64_t droppedReports = 0;
+
+  LevelUpdateMode levelUpdateMode = Config::conflateLevelUpdates ? LevelUpdateMode::Conflated : LevelUpdateMode::EveryChange;
+  SpscRing<LevelUpdate> levelUpdates;
+  uint64_t levelUpdateSequence = 0;
+  uint64_t droppedLevelUpdates = 0;
+  std::vector<LevelUpdate> conflatedUpdates; // Conflated mode, not numbered yet
+
+  // Called once a level has changed.
+  void levelChanged(bool isBuy, size_t tick, const PriceLevel& level) {
+    if (levelUpdateMode == LevelUpdateMode::Conflated) {
+      // Fills and requotes keep coming back to the same few levels, so only
+      // the latest pending updates are searched, not the whole batch.
+      const size_t end = conflatedUpdates.size();
+      const size_t begin = end > Config::levelUpdateConflationWindow ? end - Config::levelUpdateConflationWindow : 0;
+      for (size_t i = end; i-- > begin;) {
+        LevelUpdate& pending = conflatedUpdates[i];
+        if (pending.price == tick && pending.isBuy == isBuy) {
+          pending.quantity = level.totalQuantity;
+          pending.orderCount = level.orderCount;
+          return;
+        }
+      }
+      conflatedUpdates.push_back({0, level.totalQuantity, static_cast<uint32_t>(tick), level.orderCount, isBuy});
+      if (conflatedUpdates.size() >= Config::levelUpdateConflationLimit) [[unlikely]] flushLevelUpdates();
+    } else if (levelUpdateMode == LevelUpdateMode::EveryChange) {
+      emitLevelUpdate(isBuy, tick, level.totalQuantity, level.orderCount);
+    }
   }
+  void emitLevelUpdate(bool isBuy, size_t tick, uint64_t quantity, uint32_t orderCount);
+  void flushLevelUpdates();
+
+  SeqLock<TopOfBook> topOfBook; // Read by any thread
+  TopOfBook publishedTop;       // What topOfBook holds, for the owning thread
+  void publishTopOfBook();
+  bool publishPending = false; // Waiting for the end of a MatchingEngine::processBatch
+
+  // While a SnapshotCapture runs, captureEpoch is non-zero and each level the
+  // book changes is noted in changedLevels, once per epoch.
+  uint32_t captureEpoch = 0;
+  uint32_t lastCaptureEpoch = 0;
+  std::vector<std::pair<bool, uint32_t>> changedLevels; // isBuy, tick
 
-  double indexToPrice(size_t index) const {
-    return Config::minPrice + (index * Config::tickSize);
+  // Out of line, so that the vector growth stays off the matching paths.
+  void noteLevelChange(bool isBuy, size_t tick, PriceLevel& level) {
+    if (captureEpoch != 0 && level.captureEpoch != captureEpoch) [[unlikely]] {
+      recordLevelChange(isBuy, tick, level);
+    }
   }
+  [[gnu::noinline, gnu::cold]] void recordLevelChange(bool isBuy, size_t tick, PriceLevel& level);
 
   void updateBestBid();
   void updateBestAsk();
-  void processBuyMatching(uint32_t& quantity, size_t index);
-  void processSellMatching(uint32_t& quantity, size_t index);
-  void removeFrontOrder(bool isBuySide, size_t index);
-  void removeOrderFromList(Order* order);
+  void processBuyMatching(uint32_t& quantity, size_t index, uint32_t ID, ExecutionSummary& summary);
+  void processSellMatching(uint32_t& quantity, size_t index, uint32_t ID, ExecutionSummary& summary);
+  void emitReport(uint32_t aggressorId, uint32_t restingId, uint32_t price, uint32_t quantity,
+                  uint32_t aggressorRemaining, uint32_t restingRemaining);
+  void addOrderToList(OrderIndex index);
+  void removeOrderFromList(OrderIndex index);
+  bool canFill(bool isBuy, size_t index, uint32_t quantity) const;
+
+  // One instantiation per order type, so the checks of one type never sit on
+  // the path of another.
+  template <OrderType Type>
+  ExecutionSummary processOrder(bool isBuy, uint32_t price, uint32_t quantity, uint32_t timestamp, uint32_t ID);
 
 public:
-  OrderBook();
+  // Order records come from arena's slabs, shared with the other books.
+  explicit OrderBook(SlabArena& arena = SlabArena::shared());
   OrderBook(const OrderBook&) = delete;
   OrderBook& operator=(const OrderBook&) = delete;
   OrderBook(OrderBook&&) = delete;
   OrderBook& operator=(OrderBook&&) = delete;
 
-  void processOrders(bool isBuy, double price, uint32_t quantity, uint32_t timestamp, uint32_t ID, uint32_t tickerId);
+  // Prices are in ticks; price levels are indexed by tick directly.
+  // Presizes the order ID index and prefaults pool slots for the expected
+  // number of resting orders.
+  void reserve(size_t expectedOrders) {
+    orderMap.reserve(expectedOrders);
+    orderPool.reserve(expectedOrders);
+  }
+
+  // Limit order: the common path, with no order type to dispatch on.
+  ExecutionSummary processOrders(bool isBuy, uint32_t price, uint32_t quantity, uint32_t timestamp, uint32_t ID);
+  // Any order type. Market orders ignore price.
+  ExecutionSummary processOrders(OrderType type, bool isBuy, uint32_t price, uint32_t quantity, uint32_t timestamp, uint32_t ID);
   bool cancelOrder(uint32_t ID);
-  bool editOrder(uint32_t ID, double newPrice, uint32_t newQuantity);
+  bool editOrder(uint32_t ID, uint32_t newPrice, uint32_t newQuantity);
   void printOrderBookHistogram(const std::string& tickerName, int blockSize) const;
 
+  // Software prefetch for batched cancels and edits: first the ID index slot,
+  // then, once that has arrived, the order it points to.
+  void prefetchIndex(uint32_t ID) const { orderMap.prefetch(ID); }
+  void prefetchOrder(uint32_t ID) {
+    if (OrderIndex* order_ptr = orderMap.find(ID)) orderPool.prefetch(*order_ptr);
+  }
+
+  // Writes up to nLevels occupied levels of one side, best first, into out.
+  // Returns the number of levels written. O(levels), never allocates.
+  size_t getDepth(bool isBuy, size_t nLevels, DepthLevel* out) const;
+
+  // Fills of this book, in execution order. The book is the only producer;
+  // exactly one thread may consume. Empty when reporting is compiled out.
+  SpscRing<ExecutionReport>& executionReports() { return reports; }
+  // Reports lost because the ring was full (also visible as sequence gaps).
+  uint64_t droppedExecutionReports() const { return droppedReports; }
+
+  // Level changes of this book (see LevelUpdate.h). The book is the only
+  // producer; exactly one thread may consume.
+  SpscRing<LevelUpdate>& levelUpdateRing() { return levelUpdates; }
+  const SpscRing<LevelUpdate>& levelUpdateRing() const { return levelUpdates; }
+  // Updates lost because the ring was full (also visible as sequence gaps,
+  // once a later update gets through).
+  uint64_t droppedLevelUpdateCount() const { return droppedLevelUpdates; }
+  // Sequence of the next update the book publishes.
+  uint64_t nextLevelUpdateSequence() const { return levelUpdateSequence; }
+  // Publishes pending changes first when leaving Conflated mode.
+  void setLevelUpdateMode(LevelUpdateMode mode);
+  // Conflated mode: publishes the changes since the last call, with one
+  // update per level unless many other levels changed in between (see
+  // Config::levelUpdateConflationWindow). A book that collects
+  // Config::levelUpdateConflationLimit changes publishes them by itself.
+  void publishLevelUpdates() {
+    if (!conflatedUpdates.empty()) flushLevelUpdates();
+  }
+  // Publishes pending level updates and, if it moved, the top of book.
+  // MatchingEngine calls it after each of its operations and once per
+  // processBatch; other callers of the book's operations call it when their
+  // batch is done.
+  void publishMarketData() {
+    publishLevelUpdates();
+    publishTopOfBook();
+  }
+  // Any thread: the top of book as of the last publishMarketData().
+  TopOfBook getBBO() const { return topOfBook.read(); }
+  // Owning thread only: every occupied level, for a consumer to start from
+  // or resynchronise with (see L2Book). Publishes pending changes first.
+  DepthSnapshot depthSnapshot();
+
+  // Bytes currently held by both sides of the price ladder.
+  size_t ladderMemoryUsage() const { return BuyLevels.memoryUsage() + SellLevels.memoryUsage(); }
+  // Bytes held by the book: the object itself, its slabs, ID index, ladder
+  // and its report and level update rings (whose pages are only touched as
+  // entries flow).
+  size_t memoryUsage() const;
+  // Returns what a quiet book keeps for its next burst: an empty slab, spare
+  // ladder pages and ID index room beyond what its resting orders need.
+  void shrinkToFit();
+
+  size_t orderCount() const { return orderMap.size(); }
+  // Every resting order in price-time order, copied in one go. See
+  // SnapshotCapture for a book that has to keep trading meanwhile.
+  BookImage snapshot();
+  // Rebuilds an empty book from image: the pool, level queues and ID index
+  // are filled in bulk, and execution reports continue from the image's
+  // sequence. Every restored level is published as a level update, unless
+  // updates are off; a ring too small for the depth drops the rest, which
+  // the consumer sees as a gap. Returns false, leaving the book untouched, if the book is not
+  // empty or the image is malformed (levels out of order, crossed or empty,
+  // counts that do not add up, zero quantities). IDs are trusted to be unique.
+  bool restore(const BookImageView& image);
+
   friend class TestOrderBook;
+  friend class SnapshotCapture;
+  friend class MatchingEngine;
 };
+
+#endif // !ORDER_BOOK_INCLUDED
@@ -10,20 +10,73 @@
 #define ORDER_POOL_INCLUDED
 
 #include "../include/Order.h"
+#include "../include/SlabArena.h"
+#include <bit>
+#include <cstdint>
 #include <vector>
-#include <memory>
 
+// Hands out order slots by index. Index >> slabShift picks one of the pool's
+// slabs from a SlabArena, whose hot Order and cold OrderInfo records share
+// the rest of the index. A pool holds no slab until its first order. Each
+// slab chains its released slots through Order::next; a slab whose last
+// order goes is handed back to the arena unless the pool is still filling
+// it, so memory taken in a burst is returned once the burst has drained.
 class OrderPool {
 public:
-  OrderPool();
-  void deallocate(Order* order);
-  Order* allocate(uint32_t timestamp, bool isBuy, double price, uint32_t quantity, uint32_t ID, uint32_t tickerId);
+  explicit OrderPool(SlabArena& arena = SlabArena::shared()) : arena(&arena) {}
+  ~OrderPool();
+  OrderPool(const OrderPool&) = delete;
+  OrderPool& operator=(const OrderPool&) = delete;
+
+  void deallocate(OrderIndex index);
+  OrderIndex allocate(uint32_t timestamp, bool isBuy, uint32_t price, uint32_t quantity, uint32_t ID);
+
+  // Takes slabs for n more orders and faults their pages in up front, so the
+  // next n allocations take neither an arena call nor a page fault.
+  void reserve(size_t n);
+  // Hands back the slab being filled too if none of its orders are left.
+  void shrink();
+
+  Order& operator[](OrderIndex index) { return slabs[index >> slabShift]->hot[index & slabMask]; }
+  const Order& operator[](OrderIndex index) const { return slabs[index >> slabShift]->hot[index & slabMask]; }
+  void prefetch(OrderIndex index) const { __builtin_prefetch(&(*this)[index]); }
+  OrderInfo& info(OrderIndex index) { return slabs[index >> slabShift]->cold[index & slabMask]; }
+  const OrderInfo& info(OrderIndex index) const { return slabs[index >> slabShift]->cold[index & slabMask]; }
+
+  // Bytes of slabs held plus the pool's own bookkeeping.
+  size_t memoryUsage() const;
 
 private:
-  void grow();
+  static constexpr size_t slabShift = std::countr_zero(SlabArena::slabOrders);
+  static constexpr size_t slabMask = SlabArena::slabOrders - 1;
+  static constexpr uint32_t noSlab = UINT32_MAX;
+
+  struct SlabUse {
+    OrderIndex free_head = nullOrder; // Most recently released slot of the slab
+    uint32_t next_unused = 0;         // Slots from here to the end were never handed out
+    uint32_t live = 0;
+    bool listed = false;              // On the available stack
+  };
+
+  static bool full(const SlabUse& slabUse) {
+    return slabUse.free_head == nullOrder && slabUse.next_unused == SlabArena::slabOrders;
+  }
+  void switchSlab();
+  uint32_t takeSlab();
+  uint32_t newSlab();
+  void releaseSlab(uint32_t slab);
+  void releaseElsewhere(OrderIndex index);
 
-  std::vector<std::unique_ptr<std::vector<Order>>> memory_chunks;
-  std::vector<Order*> free_list;
+  SlabArena* arena;
+  std::vector<SlabArena::Slab*> slabs; // nullptr where a slab was handed back
+  std::vector<SlabUse> use;            // Parallel to slabs; current's entry is stale, see filling
+  std::vector<uint32_t> available;     // Slabs other than current with free slots; may hold stale entries
+  std::vector<uint32_t> vacant;        // Directory entries of handed back slabs
+  uint32_t current = noSlab;           // Slab allocations come from
+  // Use of current, kept here while it is filled so that the common paths
+  // never index use. Starts out looking full, as if there were a current slab.
+  SlabUse filling{nullOrder, SlabArena::slabOrders, 0, false};
+  size_t held = 0;
 };
 
 #endif // !ORDER_POOL_INCLUDED
@@ -0,0 +1,73 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef PERF_COUNTERS_INCLUDED
+#define PERF_COUNTERS_INCLUDED
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Hardware events counted per replay thread.
+enum PerfEvent : size_t {
+  PerfCycles,
+  PerfInstructions,
+  PerfL1dMisses,  // L1 data cache read misses
+  PerfLlcMisses,  // Last level cache misses
+  PerfDtlbMisses, // Data TLB read misses
+  PerfBranchMisses,
+  PerfEventCount
+};
+
+// Counts of one measured interval. An event the kernel or the CPU would not
+// count is left invalid rather than zero.
+struct PerfCounts {
+  std::array<uint64_t, PerfEventCount> values{};
+  std::array<bool, PerfEventCount> valid{};
+
+  bool any() const {
+    for (bool v : valid) if (v) return true;
+    return false;
+  }
+  // Adds the events other counted, e.g. to total several threads.
+  void merge(const PerfCounts& other) {
+    for (size_t i = 0; i < PerfEventCount; ++i) {
+      if (!other.valid[i]) continue;
+      values[i] += other.values[i];
+      valid[i] = true;
+    }
+  }
+};
+
+// perf_event_open counters of the calling thread, user space only. Each
+// event is opened on its own, so one the PMU lacks does not take the others
+// down, and counts are scaled up when the kernel multiplexed the counter.
+// Where perf events are unavailable (not Linux, a container without a PMU,
+// perf_event_paranoid too high) every event is simply invalid.
+class PerfCounters {
+public:
+  PerfCounters();
+  ~PerfCounters();
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  bool available() const;
+  // Zeroes and starts every open counter.
+  void start();
+  // Stops the counters and returns what they counted since start().
+  PerfCounts stop();
+
+  static const char* name(PerfEvent event);
+  // Why the first event that failed to open did, e.g. "No such file or
+  // directory" for a missing PMU; nullptr if none failed.
+  static const char* openError();
+
+private:
+  std::array<int, PerfEventCount> fds;
+};
+
+#endif // !PERF_COUNTERS_INCLUDED
@@ -0,0 +1,32 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef PRICE_INCLUDED
+#define PRICE_INCLUDED
+
+#include <cmath>
+#include <cstdint>
+#include "Configuration.h"
+
+// Prices travel through the engine as integer ticks on the Config::tickSize grid.
+// Doubles only exist at the edges: display and the convenience overloads.
+
+// Returned for negative, NaN or out of range prices; the book rejects it.
+constexpr uint32_t invalidPriceTicks = UINT32_MAX;
+
+inline uint32_t priceToTicks(double price) {
+  if (!(price >= 0.0 && price < Config::maxPriceTicks * Config::tickSize)) {
+    return invalidPriceTicks;
+  }
+  return static_cast<uint32_t>(std::llround(price * Config::ticksPerUnit));
+}
+
+inline double ticksToPrice(uint32_t ticks) {
+  return ticks * Config::tickSize;
+}
+
+#endif // !PRICE_INCLUDED
@@ -0,0 +1,125 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef PRICE_LADDER_INCLUDED
+#define PRICE_LADDER_INCLUDED
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Configuration.h"
+#include "LevelBitmap.h"
+#include "PriceLevel.h"
+
+// One side of the book, indexed by absolute tick. The ladder covers a window
+// [baseTick, baseTick + pages * pageLevels). When a price falls outside it,
+// the window is rebuilt in whole pages around the occupied range and the new
+// price, and once the side is empty the next order re-anchors it. Only pages holding at least one occupied level are allocated, so
+// resident memory follows the occupied range: a page pointer and one
+// occupancy bit per level of the window, plus one page per occupied page.
+class PriceLadder {
+public:
+  static constexpr size_t npos = LevelBitmap::npos;
+  static constexpr size_t pageShift = Config::ladderPageShift;
+  static constexpr size_t pageLevels = size_t{1} << pageShift;
+  static constexpr size_t pageMask = pageLevels - 1;
+
+  PriceLadder() = default;
+
+  // Level at tick. The tick must be occupied or have just been acquire()d.
+  PriceLevel& levelAt(size_t tick) {
+    size_t rel = tick - baseTick;
+    return pages[rel >> pageShift]->levels[rel & pageMask];
+  }
+
+  const PriceLevel& levelAt(size_t tick) const {
+    size_t rel = tick - baseTick;
+    return pages[rel >> pageShift]->levels[rel & pageMask];
+  }
+
+  // Level at tick, or nullptr if its page is not resident.
+  const PriceLevel* find(size_t tick) const {
+    if (tick < baseTick) return nullptr;
+    size_t rel = tick - baseTick;
+    if ((rel >> pageShift) >= pages.size()) return nullptr;
+    const Page* page = pages[rel >> pageShift].get();
+    return page ? &page->levels[rel & pageMask] : nullptr;
+  }
+
+  // Level at tick, growing the window and allocating its page if needed.
+  PriceLevel& acquire(size_t tick) {
+    size_t rel = tick - baseTick; // Wraps to a huge value below the window
+    if ((rel >> pageShift) >= pages.size()) {
+      grow(tick);
+      rel = tick - baseTick;
+    }
+    std::unique_ptr<Page>& page = pages[rel >> pageShift];
+    if (!page) allocatePage(page);
+    return page->levels[rel & pageMask];
+  }
+
+  // The level at tick received its first order.
+  void markOccupied(size_t tick) {
+    size_t rel = tick - baseTick;
+    occupied.set(rel);
+    pages[rel >> pageShift]->occupiedLevels++;
+  }
+
+  // The level at tick lost its last order. Releases the page once it holds
+  // no occupied level, so references into it must not be used afterwards.
+  void markEmpty(size_t tick) {
+    size_t rel = tick - baseTick;
+    occupied.clear(rel);
+    std::unique_ptr<Page>& page = pages[rel >> pageShift];
+    if (--page->occupiedLevels == 0) releasePage(page);
+  }
+
+  // Lowest occupied tick >= tick, or npos.
+  size_t findNextOccupied(size_t tick) const {
+    size_t rel = (tick < baseTick) ? 0 : tick - baseTick;
+    size_t found = occupied.findNextSet(rel);
+    return (found == npos) ? npos : found + baseTick;
+  }
+
+  // Highest occupied tick <= tick, or npos.
+  size_t findPrevOccupied(size_t tick) const {
+    if (tick < baseTick) return npos;
+    size_t found = occupied.findPrevSet(tick - baseTick);
+    return (found == npos) ? npos : found + baseTick;
+  }
+
+  size_t lowestOccupied() const { return findNextOccupied(baseTick); }
+  size_t highestOccupied() const { return findPrevOccupied(npos - 1); }
+  bool empty() const { return occupied.empty(); }
+
+  // Bytes held by the directory, the occupancy bitmap and resident pages.
+  size_t memoryUsage() const;
+  // Frees the spare page and, once the side is empty, the whole window; the
+  // next order re-anchors it.
+  void shrinkToFit();
+
+private:
+  struct Page {
+    std::array<PriceLevel, pageLevels> levels{};
+    uint32_t occupiedLevels = 0;
+  };
+
+  void grow(size_t tick);
+  void allocatePage(std::unique_ptr<Page>& slot);
+  void releasePage(std::unique_ptr<Page>& slot);
+
+  size_t baseTick = 0;
+  std::vector<std::unique_ptr<Page>> pages; // Window directory, nullptr for empty pages
+  LevelBitmap occupied;                     // One bit per level of the window
+  std::unique_ptr<Page> sparePage;          // Avoids churn when the top level flips pages
+  size_t residentPages = 0;
+};
+
+#endif // !PRICE_LADDER_INCLUDED
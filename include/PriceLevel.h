@@ -0,0 +1,31 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef PRICE_LEVEL_INCLUDED
+#define PRICE_LEVEL_INCLUDED
+
+#include <cstdint>
+#include "Order.h"
+
+// One price level of one side: the FIFO queue of resting orders plus running
+// aggregates, so depth queries never have to walk the queue.
+struct PriceLevel {
+  OrderIndex head = nullOrder;
+  OrderIndex tail = nullOrder;
+  uint64_t totalQuantity = 0;
+  uint32_t orderCount = 0;
+  uint32_t captureEpoch = 0; // See SnapshotCapture; takes what was padding
+};
+
+// One row of an L2 depth snapshot.
+struct DepthLevel {
+  uint32_t price; // In ticks
+  uint64_t quantity;
+  uint32_t orderCount;
+};
+
+#endif // !PRICE_LEVEL_INCLUDED
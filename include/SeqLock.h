@@ -0,0 +1,75 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef SEQ_LOCK_INCLUDED
+#define SEQ_LOCK_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// A small record written by one thread and read by any number of others
+// without locks. The writer makes the sequence odd, stores the record and
+// makes the sequence even again; a reader copies the record between two
+// loads of the sequence and retries if they differ or are odd, so it never
+// sees a torn record and never holds up the writer. The record is kept as
+// relaxed atomic words, which compile to plain loads and stores but keep the
+// concurrent accesses well defined. Sequence and record sit on a cache line
+// of their own, so readers only ever miss on a write.
+template <class T>
+class alignas(64) SeqLock {
+  static_assert(std::is_trivially_copyable_v<T> && sizeof(T) % sizeof(uint64_t) == 0,
+                "SeqLock copies T as whole words");
+
+public:
+  SeqLock() { write(T{}); }
+
+  SeqLock(const SeqLock&) = delete;
+  SeqLock& operator=(const SeqLock&) = delete;
+
+  // Writer thread only.
+  void write(const T& value) {
+    uint64_t words[wordCount];
+    std::memcpy(words, &value, sizeof(T));
+    const uint64_t s = sequence.load(std::memory_order_relaxed);
+    sequence.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < wordCount; ++i) {
+      data[i].store(words[i], std::memory_order_relaxed);
+    }
+    sequence.store(s + 2, std::memory_order_release);
+  }
+
+  // Any thread.
+  T read() const {
+    uint64_t words[wordCount];
+    for (;;) {
+      const uint64_t before = sequence.load(std::memory_order_acquire);
+      for (size_t i = 0; i < wordCount; ++i) {
+        words[i] = data[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if ((before & 1) == 0 && sequence.load(std::memory_order_relaxed) == before) break;
+    }
+    T value;
+    std::memcpy(&value, words, sizeof(T));
+    return value;
+  }
+
+  // Writes so far, counting the initial one; any thread.
+  uint64_t writes() const { return sequence.load(std::memory_order_acquire) / 2; }
+
+private:
+  static constexpr size_t wordCount = sizeof(T) / sizeof(uint64_t);
+
+  std::atomic<uint64_t> sequence{0};
+  std::atomic<uint64_t> data[wordCount];
+};
+
+#endif // !SEQ_LOCK_INCLUDED
@@ -0,0 +1,107 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+
+#ifndef SHARDED_ENGINE_INCLUDED
+#define SHARDED_ENGINE_INCLUDED
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "InputJournal.h"
+#include "Instruction.h"
+#include "MatchingEngine.h"
+#include "MpscRing.h"
+
+// MatchingEngine for several gateway threads at once. Books are split across
+// shards by tickerId % shardCount. Each shard has one worker thread, the only
+// thread that touches its books, and a bounded MPSC ingress queue that any
+// thread may submit() to. A ticker's instructions from one producer are
+// matched in the order they were submitted; there is no order between
+// producers.
+class ShardedEngine {
+public:
+  // What a worker has done so far. A snapshot; the counts move while it runs.
+  struct ShardStats {
+    uint64_t processed = 0;
+    uint64_t accepted = 0;          // See InstructionResult::accepted
+    uint64_t rejectedSubmits = 0;   // submit() calls refused because the queue was full
+    uint64_t queueLatencyNsTotal = 0; // From submit() to the worker taking the instruction
+    uint64_t queueLatencyNsMax = 0;
+    uint64_t journalOverflows = 0;  // Batches the shard's journal buffered in memory, its ring full
+  };
+
+  // Worker i is pinned to cpus[i % cpus.size()]; with no cpus the scheduler
+  // places them.
+  explicit ShardedEngine(size_t shardCount, std::vector<int> cpus = {});
+  ~ShardedEngine();
+
+  ShardedEngine(const ShardedEngine&) = delete;
+  ShardedEngine& operator=(const ShardedEngine&) = delete;
+
+  // Journals each shard's instructions to directory/shard-<i>.journal before
+  // they are matched (see InputJournal), for replay_journal to rebuild the
+  // books from. Call before start(). Returns false, journaling nothing, if a
+  // journal cannot be created, as when one is left from an earlier run.
+  bool enableJournal(const std::string& directory, JournalMode mode);
+  // The shard's journal, or nullptr when journaling is off.
+  const InputJournal* journal(size_t shard) const { return shards[shard]->journal.get(); }
+
+  void start();
+  // Lets the workers drain their queues, then joins them and flushes the
+  // journals. Producers must have stopped submitting.
+  void stop();
+
+  // Never blocks. Returns false when the shard's queue is full, leaving the
+  // caller to retry, slow down or shed the instruction, and for an unknown
+  // ticker.
+  bool submit(const Instruction& instruction);
+
+  size_t shardCount() const { return shards.size(); }
+  size_t shardOf(uint32_t tickerId) const { return tickerId % shards.size(); }
+  ShardStats stats(size_t shard) const;
+  // Whether pinning the shard's worker succeeded, once started.
+  bool pinned(size_t shard) const { return shards[shard]->pinned.load(std::memory_order_relaxed); }
+
+  // The books, for setup before start() and inspection after stop().
+  MatchingEngine& engine() { return matchingEngine; }
+
+private:
+  struct Request {
+    Instruction instruction;
+    uint64_t submitNs;
+  };
+
+  struct Shard {
+    explicit Shard(size_t capacity) : queue(capacity) {}
+
+    MpscRing<Request> queue;
+    std::thread worker;
+    int cpu = -1;
+    std::atomic<bool> pinned{false};
+    std::atomic<uint64_t> rejectedSubmits{0};
+    // Written by the worker only
+    std::atomic<uint64_t> processed{0};
+    std::atomic<uint64_t> accepted{0};
+    std::atomic<uint64_t> queueLatencyNsTotal{0};
+    std::atomic<uint64_t> queueLatencyNsMax{0};
+    std::atomic<uint64_t> journalOverflows{0};
+    std::unique_ptr<InputJournal> journal;
+  };
+
+  void run(Shard& shard);
+
+  MatchingEngine matchingEngine;
+  std::vector<std::unique_ptr<Shard>> shards;
+  std::atomic<bool> running{false};
+};
+
+#endif // !SHARDED_ENGINE_INCLUDED
@@ -0,0 +1,77 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef SLAB_ARENA_INCLUDED
+#define SLAB_ARENA_INCLUDED
+
+#include <bit>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include "Configuration.h"
+#include "Order.h"
+
+// Fixed-size slabs of order records shared by every OrderPool of an engine,
+// so thousands of books pay for the orders they hold rather than for a
+// private chunk each. Slabs are carved out of large anonymous mappings,
+// huge-page backed where the kernel allows. Released slabs are reused first;
+// beyond Config::slabArenaWarmSlabs free ones their pages go back to the OS,
+// except in explicit (MAP_HUGETLB) huge page regions, whose free slabs all
+// stay warm.
+// Thread-safe: books run on different threads take and return slabs here,
+// once per Config::orderSlabOrders orders at most.
+class SlabArena {
+public:
+  static constexpr size_t slabOrders = Config::orderSlabOrders;
+
+  // Hot Order records and cold OrderInfo records of the same slot index.
+  struct Slab {
+    Order hot[slabOrders];
+    OrderInfo cold[slabOrders];
+  };
+  static_assert(std::has_single_bit(slabOrders), "Slab size must be a power of two");
+  static_assert(sizeof(Slab) % 4096 == 0, "Slabs must be whole pages so they can be returned to the OS");
+
+  SlabArena() = default;
+  ~SlabArena();
+  SlabArena(const SlabArena&) = delete;
+  SlabArena& operator=(const SlabArena&) = delete;
+
+  // A slab with indeterminate contents. Throws std::bad_alloc when the OS
+  // refuses a new mapping.
+  Slab* acquire();
+  void release(Slab* slab);
+
+  // Slabs currently held by books.
+  size_t slabsInUse() const;
+  // Bytes of slabs held by books or kept warm for reuse.
+  size_t residentBytes() const;
+  // Bytes of address space mapped so far.
+  size_t mappedBytes() const;
+
+  // Arena of books built without one.
+  static SlabArena& shared();
+
+private:
+  struct Region {
+    void* base;
+    bool hugetlb; // Explicit huge pages, which madvise cannot drop per slab
+  };
+
+  void mapRegion();
+  bool inHugetlbRegion(const Slab* slab) const;
+
+  mutable std::mutex mutex;
+  std::vector<Region> regions;
+  std::vector<Slab*> warm;  // Free, pages still resident
+  std::vector<Slab*> cold;  // Free, pages returned to the OS
+  size_t carved = 0;        // Slabs taken from the last region so far
+  size_t inUse = 0;
+};
+
+#endif // !SLAB_ARENA_INCLUDED
@@ -0,0 +1,140 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef SPSC_RING_INCLUDED
+#define SPSC_RING_INCLUDED
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Bounded lock-free ring for exactly one producer thread and one consumer
+// thread. Storage is allocated once in the constructor and default-initialised
+// only, so the pages of a large ring of plain records are faulted in as items
+// pass through rather than up front. Each side caches the other side's index
+// and only reloads it when the ring looks full (producer) or empty
+// (consumer), so a push or pop is normally one store to a cache line the
+// other side does not read.
+template <class T>
+class SpscRing {
+public:
+  // capacity is rounded up to a power of two.
+  explicit SpscRing(size_t capacity)
+    : mask(std::bit_ceil(capacity < 2 ? size_t{2} : capacity) - 1),
+      slots(std::make_unique_for_overwrite<T[]>(mask + 1)) {}
+
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+
+  size_t capacity() const { return mask + 1; }
+
+  // Producer side. Returns false, leaving the ring untouched, when it is full.
+  bool tryPush(const T& item) {
+    const uint64_t t = tail.load(std::memory_order_relaxed);
+    if (t - cachedHead > mask) {
+      cachedHead = head.load(std::memory_order_acquire);
+      if (t - cachedHead > mask) return false;
+    }
+    slots[t & mask] = item;
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Producer side. Pushes all count items, or none and returns false when
+  // fewer than count slots are free.
+  bool tryPushBatch(const T* items, size_t count) {
+    const uint64_t t = tail.load(std::memory_order_relaxed);
+    if (t + count - cachedHead > mask + 1) {
+      cachedHead = head.load(std::memory_order_acquire);
+      if (t + count - cachedHead > mask + 1) return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      slots[(t + i) & mask] = items[i];
+    }
+    tail.store(t + count, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Returns false when the ring is empty.
+  bool tryPop(T& item) {
+    const uint64_t h = head.load(std::memory_order_relaxed);
+    if (h == cachedTail) {
+      cachedTail = tail.load(std::memory_order_acquire);
+      if (h == cachedTail) return false;
+    }
+    item = slots[h & mask];
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Pops up to maxItems into out and returns how many.
+  size_t popBatch(T* out, size_t maxItems) {
+    const uint64_t h = head.load(std::memory_order_relaxed);
+    if (cachedTail - h < maxItems) {
+      cachedTail = tail.load(std::memory_order_acquire);
+    }
+    size_t n = static_cast<size_t>(cachedTail - h);
+    if (n > maxItems) n = maxItems;
+    for (size_t i = 0; i < n; ++i) {
+      out[i] = slots[(h + i) & mask];
+    }
+    head.store(h + n, std::memory_order_release);
+    return n;
+  }
+
+  // Producer side, in place: the slot the next push fills, or nullptr when
+  // the ring is full. publish() hands the filled slot to the consumer.
+  T* claim() {
+    const uint64_t t = tail.load(std::memory_order_relaxed);
+    if (t - cachedHead > mask) {
+      cachedHead = head.load(std::memory_order_acquire);
+      if (t - cachedHead > mask) return nullptr;
+    }
+    return &slots[t & mask];
+  }
+
+  void publish() {
+    tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  // Consumer side, in place: the oldest slot, or nullptr when the ring is
+  // empty. release() gives it back to the producer.
+  const T* front() {
+    const uint64_t h = head.load(std::memory_order_relaxed);
+    if (h == cachedTail) {
+      cachedTail = tail.load(std::memory_order_acquire);
+      if (h == cachedTail) return nullptr;
+    }
+    return &slots[h & mask];
+  }
+
+  void release() {
+    head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  // Approximate when called concurrently with either side.
+  size_t size() const {
+    return static_cast<size_t>(tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire));
+  }
+
+  bool empty() const { return size() == 0; }
+
+private:
+  static constexpr size_t cacheLine = 64;
+
+  const size_t mask;
+  const std::unique_ptr<T[]> slots;
+
+  alignas(cacheLine) std::atomic<uint64_t> tail{0}; // Written by the producer
+  uint64_t cachedHead = 0;                          // Producer's copy of head
+  alignas(cacheLine) std::atomic<uint64_t> head{0}; // Written by the consumer
+  uint64_t cachedTail = 0;                          // Consumer's copy of tail
+};
+
+#endif // !SPSC_RING_INCLUDED
@@ -2,6 +2,20 @@
 #define TICKER_RESULT_INCLUDED
 
 #include <string>
+#include <vector>
+
+#include "LatencyHistogram.h"
+#include "PerfCounters.h"
+
+// Latency histograms kept per instruction type; an add that filled anything
+// is timed apart from one that only rested.
+enum LatencyKind : size_t {
+    AddRestLatency,
+    AddMatchLatency,
+    CancelLatency,
+    EditLatency,
+    LatencyKindCount
+};
 
 struct TickerResult {
     std::string name;
@@ -12,6 +26,11 @@ struct TickerResult {
     long long failed_cancels = 0;
     long long failed_edits = 0;
     double time_ms = 0.0;
+    // TSC ticks per instruction, indexed by LatencyKind. Empty unless
+    // Config::recordLatencyHistograms.
+    std::vector<LatencyHistogram> latency;
+    // Hardware counters of the replay thread, where perf events are available.
+    PerfCounts perf;
 };
 
 #endif // !TICKER_RESULT_INCLUDED
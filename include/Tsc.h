@@ -0,0 +1,52 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef TSC_INCLUDED
+#define TSC_INCLUDED
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Cheap timestamps for timing single operations. On x86 this is the time
+// stamp counter, a few cycles per read and not serialising, so an interval
+// may be off by the handful of instructions the CPU reorders around it.
+// Elsewhere it falls back to steady_clock nanoseconds.
+inline uint64_t readTsc() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Nanoseconds per readTsc() tick, measured once against steady_clock over
+// about 20ms on first use. Assumes an invariant TSC, as on any recent x86.
+inline double tscNanosPerTick() {
+  static const double nanosPerTick = [] {
+#if defined(__x86_64__) || defined(__i386__)
+    using clock = std::chrono::steady_clock;
+    const auto wallStart = clock::now();
+    const uint64_t tscStart = readTsc();
+    while (clock::now() - wallStart < std::chrono::milliseconds(20)) {
+    }
+    const uint64_t tscEnd = readTsc();
+    const auto wallEnd = clock::now();
+    const double nanos = std::chrono::duration<double, std::nano>(wallEnd - wallStart).count();
+    return (tscEnd > tscStart) ? nanos / static_cast<double>(tscEnd - tscStart) : 1.0;
+#else
+    return 1.0;
+#endif
+  }();
+  return nanosPerTick;
+}
+
+#endif // !TSC_INCLUDED
@@ -0,0 +1,71 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef WORK_STEALING_QUEUE_INCLUDED
+#define WORK_STEALING_QUEUE_INCLUDED
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Bounded queue of 32-bit task IDs with one owner and any number of takers,
+// the top half of a Chase-Lev deque. Only the owning thread pushes; any
+// thread, the owner included, takes the oldest task with one compare-and-swap,
+// so tasks run first in first out wherever they end up. The capacity is
+// fixed: callers size it for the most tasks that can ever be queued at once,
+// and push() must not be called beyond that.
+class WorkStealingQueue {
+public:
+  static constexpr uint32_t empty = UINT32_MAX;
+
+  // capacity is rounded up to a power of two.
+  explicit WorkStealingQueue(size_t capacity)
+    : mask(std::bit_ceil(capacity < 2 ? size_t{2} : capacity) - 1),
+      tasks(std::make_unique<std::atomic<uint32_t>[]>(mask + 1)) {}
+
+  WorkStealingQueue(const WorkStealingQueue&) = delete;
+  WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+
+  // Owner only.
+  void push(uint32_t task) {
+    const uint64_t b = bottom.load(std::memory_order_relaxed);
+    tasks[b & mask].store(task, std::memory_order_relaxed);
+    bottom.store(b + 1, std::memory_order_release);
+  }
+
+  // Any thread. The oldest task, or empty when there is none or another
+  // thread took it first.
+  uint32_t take() {
+    uint64_t t = top.load(std::memory_order_acquire);
+    const uint64_t b = bottom.load(std::memory_order_acquire);
+    if (t >= b) return empty;
+    const uint32_t task = tasks[t & mask].load(std::memory_order_relaxed);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+      return empty;
+    }
+    return task;
+  }
+
+  // Approximate when called concurrently.
+  size_t size() const {
+    const uint64_t t = top.load(std::memory_order_acquire); // Before bottom, so never past it
+    return static_cast<size_t>(bottom.load(std::memory_order_acquire) - t);
+  }
+
+private:
+  static constexpr size_t cacheLine = 64;
+
+  const size_t mask;
+  const std::unique_ptr<std::atomic<uint32_t>[]> tasks;
+
+  alignas(cacheLine) std::atomic<uint64_t> top{0};    // Advanced by takers
+  alignas(cacheLine) std::atomic<uint64_t> bottom{0}; // Written by the owner
+};
+
+#endif // !WORK_STEALING_QUEUE_INCLUDED
@@ -0,0 +1,149 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#ifndef WORKLOAD_GENERATOR_INCLUDED
+#define WORKLOAD_GENERATOR_INCLUDED
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "Configuration.h"
+#include "Instruction.h"
+
+// Parameters of a synthetic order flow. Prices and offsets are in ticks,
+// durations in instructions of the ticker unless noted. The defaults come
+// from Config.
+struct WorkloadModel {
+  uint64_t seed = Config::workloadSeed;
+
+  // Activity across tickers: the k-th busiest gets a share proportional to
+  // 1 / k^tickerZipfExponent. 0 gives every ticker the same volume.
+  size_t tickerCount = Config::tickers.size();
+  double tickerZipfExponent = Config::tickerZipfExponent;
+
+  // Relative weights of adds and edits among the instructions that are not
+  // cancels. How many cancels there are follows from the lifetimes below.
+  int addWeight = Config::addInstructionWeight;
+  int editWeight = Config::editInstructionWeight;
+
+  // Each ticker's mid starts uniformly between these and random-walks a tick
+  // at a time, staying inside them.
+  double minMidPrice = Config::minGenPrice;
+  double maxMidPrice = Config::maxGenPrice;
+  double midStepProbability = Config::midStepProbability;
+
+  // Passive orders rest 1 + Exponential(passiveOffsetMean) ticks behind the
+  // mid. Marketable ones are priced 1 + Exponential(marketableOffsetMean)
+  // ticks past it on the other side, so they cross whatever rests near the
+  // mid, and are not tracked for cancels or edits. Offsets are rounded down
+  // and capped at maxPassiveOffset.
+  double passiveOffsetMean = Config::passiveOffsetMean;
+  uint32_t maxPassiveOffset = Config::maxPassiveOffset;
+  double marketableRatio = Config::marketableRatio;
+  double marketableOffsetMean = Config::marketableOffsetMean;
+
+  // Quantities are lots of 10, Pareto(minGenQty, quantityTailIndex) capped
+  // at maxGenQty: mostly small, with a heavy tail.
+  double quantityTailIndex = Config::quantityTailIndex;
+
+  // An order's lifetime until its cancel: Exponential(fastCancelMean) for a
+  // fastCancelShare of orders, Exponential(slowCancelMean) for the rest. Once
+  // a lifetime has run out, the ticker's next instruction is that order's
+  // cancel; orders that come due together go out one per instruction, in
+  // the order they expired.
+  double fastCancelShare = Config::fastCancelShare;
+  double fastCancelMean = Config::fastCancelMean;
+  double slowCancelMean = Config::slowCancelMean;
+
+  // Bursts start on a ticker with burstStartProbability per instruction and
+  // last Exponential(burstLengthMean) instructions. During one, the ticker
+  // trades burstIntensity times as often, its mid moves burstIntensity times
+  // as often, and burstMarketableRatio of its adds are marketable.
+  double burstStartProbability = Config::burstStartProbability;
+  double burstLengthMean = Config::burstLengthMean;
+  double burstIntensity = Config::burstIntensity;
+  double burstMarketableRatio = Config::burstMarketableRatio;
+
+  // Mean gap between instructions outside bursts, in timestamp units.
+  double meanArrivalGap = Config::meanArrivalGap;
+  // Share of cancels and edits sent for an order that is already gone.
+  double staleProbability = Config::staleInstruction ? Config::staleInstructionProbability : 0.0;
+};
+
+// Generates a seeded order flow. Every ticker's flow has its own random
+// stream derived from the seed and its ticker ID, so a ticker's instructions
+// do not depend on which other tickers are generated alongside it, nor on
+// threads. All draws are made from the raw std::mt19937_64 output, whose
+// sequence the standard fixes; the std:: distributions are not used, since
+// each standard library implements them differently. The draws are shaped
+// with std::log1p and std::pow, though, whose last bits are up to the math
+// library: a seed gives the same flow on every run with one libm, but not
+// necessarily bit for bit under another.
+//
+// Orders are not matched while generating, so cancels and edits may name
+// orders the book has filled in the meantime, as in the original generator.
+class WorkloadGenerator {
+public:
+  // Interleaves the flows of all of the model's tickers, each drawn in turn
+  // with probability of its Zipf share (scaled up while it bursts).
+  explicit WorkloadGenerator(const WorkloadModel& model);
+  // The flow of a single ticker.
+  WorkloadGenerator(const WorkloadModel& model, uint16_t tickerId);
+
+  Instruction next();
+  // Appends count instructions to out.
+  void generate(size_t count, std::vector<Instruction>& out);
+
+  // The count instructions of a whole interleaved workload.
+  static std::vector<Instruction> generate(const WorkloadModel& model, size_t count);
+  // How many of total instructions go to each ticker under the Zipf shares,
+  // for generating the tickers separately.
+  static std::vector<size_t> tickerShares(const WorkloadModel& model, size_t total);
+
+private:
+  struct LiveOrder {
+    uint64_t cancelDue; // Ticker's instruction count at which it expires
+    uint32_t ID;
+    bool isBuy;
+  };
+
+  struct TickerFlow {
+    std::mt19937_64 rng;
+    uint16_t tickerId = 0;
+    uint32_t mid = 0;
+    uint32_t nextId = Config::initialOrderId;
+    uint64_t generated = 0;
+    uint64_t burstLeft = 0;
+    std::vector<LiveOrder> live; // Min-heap on cancelDue
+    std::vector<LiveOrder> gone; // Recently cancelled orders, for stale instructions
+    size_t goneNext = 0;
+  };
+
+  WorkloadModel model;
+  std::vector<TickerFlow> flows;
+  std::mt19937_64 pickRng;
+  std::vector<double> shares;  // Zipf weight of each flow
+  std::vector<double> cumulative; // Weights scaled by bursts, summed
+  bool weightsChanged = true;
+  uint32_t minMid;
+  uint32_t maxMid;
+  double elapsed = 0.0; // Since Config::initialTimestamp
+
+  TickerFlow makeFlow(uint16_t tickerId) const;
+  size_t pickFlow();
+  void advanceBurst(TickerFlow& flow);
+  Instruction nextOf(TickerFlow& flow);
+  void addOrder(TickerFlow& flow, Instruction& out);
+  void cancelOrder(TickerFlow& flow, Instruction& out);
+  void editOrder(TickerFlow& flow, Instruction& out);
+  uint32_t passivePrice(TickerFlow& flow, bool isBuy);
+  uint32_t quantity(TickerFlow& flow);
+  bool drawStale(TickerFlow& flow);
+};
+
+#endif // !WORKLOAD_GENERATOR_INCLUDED
@@ -0,0 +1,165 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <algorithm>
+#include <iterator>
+#include <span>
+
+#include "../include/BookScheduler.h"
+#include "../include/Configuration.h"
+
+namespace {
+
+void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#endif
+}
+
+} // namespace
+
+BookScheduler::BookScheduler(MatchingEngine& engine, size_t workerCount) : matchingEngine(engine) {
+  if (workerCount == 0) workerCount = std::thread::hardware_concurrency();
+  workerCount = std::max<size_t>(workerCount, 1);
+
+  books.reserve(engine.bookCount());
+  for (size_t i = 0; i < engine.bookCount(); ++i) {
+    books.push_back(std::make_unique<Book>(Config::bookInboxCapacity));
+  }
+  // A book sits on at most one queue or handoff ring at a time, so sized for
+  // every book neither can overflow.
+  workers.reserve(workerCount);
+  for (size_t i = 0; i < workerCount; ++i) {
+    workers.push_back(std::make_unique<Worker>(books.size()));
+  }
+}
+
+BookScheduler::~BookScheduler() {
+  stop();
+}
+
+void BookScheduler::start() {
+  if (running.exchange(true)) return;
+  for (size_t i = 0; i < workers.size(); ++i) {
+    workers[i]->thread = std::thread(&BookScheduler::run, this, i);
+  }
+}
+
+void BookScheduler::stop() {
+  if (!running.exchange(false)) return;
+  for (auto& worker : workers) {
+    worker->thread.join();
+  }
+}
+
+bool BookScheduler::submit(const Instruction& instruction) {
+  if (instruction.tickerId >= books.size()) return false;
+  Book& book = *books[instruction.tickerId];
+  if (!book.inbox.tryPush(instruction)) {
+    rejected.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  // Pairs with the fence in runBook(): either the worker giving the book up
+  // sees this instruction, or this sees the book given up.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!book.scheduled.exchange(true, std::memory_order_acq_rel)) {
+    workers[instruction.tickerId % workers.size()]->handoff.tryPush(instruction.tickerId);
+  }
+  return true;
+}
+
+BookScheduler::WorkerStats BookScheduler::stats(size_t worker) const {
+  const Worker& w = *workers[worker];
+  return {w.processed.load(std::memory_order_relaxed),
+          w.accepted.load(std::memory_order_relaxed),
+          w.bookRuns.load(std::memory_order_relaxed),
+          w.steals.load(std::memory_order_relaxed)};
+}
+
+void BookScheduler::run(size_t self) {
+  Worker& worker = *workers[self];
+  uint32_t rng = 0x9e3779b9u * static_cast<uint32_t>(self + 1);
+  size_t idle = 0;
+
+  for (;;) {
+    const uint32_t tickerId = next(self, rng);
+    if (tickerId == WorkStealingQueue::empty) {
+      // Every submit() has returned before stop(), so once stopped nothing
+      // new reaches this worker's handoff ring; books still queued elsewhere
+      // are finished by their owners.
+      if (!running.load(std::memory_order_acquire) && worker.handoff.size() == 0 && worker.queue.size() == 0) break;
+      if (++idle < Config::shardIdleSpins) {
+        cpuRelax();
+      } else {
+        std::this_thread::yield();
+      }
+      continue;
+    }
+    idle = 0;
+    runBook(worker, tickerId);
+  }
+}
+
+uint32_t BookScheduler::next(size_t self, uint32_t& rng) {
+  Worker& worker = *workers[self];
+  uint32_t ready[Config::instructionBatchSize];
+  size_t n;
+  while ((n = worker.handoff.popBatch(ready, std::size(ready))) > 0) {
+    for (size_t i = 0; i < n; ++i) worker.queue.push(ready[i]);
+  }
+
+  uint32_t tickerId = worker.queue.take();
+  if (tickerId != WorkStealingQueue::empty) return tickerId;
+
+  // Steal, starting from a random victim so that thieves spread out
+  rng = rng * 1664525 + 1013904223;
+  const size_t count = workers.size();
+  const size_t first = (rng >> 8) % count;
+  for (size_t i = 0; i < count; ++i) {
+    const size_t victim = (first + i) % count;
+    if (victim == self) continue;
+    tickerId = workers[victim]->queue.take();
+    if (tickerId != WorkStealingQueue::empty) {
+      worker.steals.store(worker.steals.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+      return tickerId;
+    }
+  }
+  return WorkStealingQueue::empty;
+}
+
+void BookScheduler::runBook(Worker& worker, uint32_t tickerId) {
+  Book& book = *books[tickerId];
+  Instruction batch[Config::instructionBatchSize];
+  InstructionResult results[Config::instructionBatchSize];
+  size_t processed = 0;
+  uint64_t accepted = 0;
+
+  while (processed < Config::bookRunBudget) {
+    const size_t want = std::min(Config::instructionBatchSize, Config::bookRunBudget - processed);
+    const size_t n = book.inbox.popBatch(batch, want);
+    if (n == 0) break;
+    matchingEngine.processBatch(std::span<const Instruction>(batch, n), std::span<InstructionResult>(results, n));
+    for (size_t i = 0; i < n; ++i) {
+      accepted += results[i].accepted;
+    }
+    processed += n;
+  }
+
+  worker.processed.store(worker.processed.load(std::memory_order_relaxed) + processed, std::memory_order_relaxed);
+  worker.accepted.store(worker.accepted.load(std::memory_order_relaxed) + accepted, std::memory_order_relaxed);
+  worker.bookRuns.store(worker.bookRuns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+  if (book.inbox.size() == 0) {
+    book.scheduled.store(false, std::memory_order_release);
+    // A submit() that still found the book scheduled left its instruction to
+    // us, so look again once the flag is clear.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (book.inbox.size() == 0 || book.scheduled.exchange(true, std::memory_order_acq_rel)) return;
+  }
+  // Still busy: back of the queue, behind the books that waited meanwhile
+  worker.queue.push(tickerId);
+}
@@ -0,0 +1,253 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+
+#include "../include/BookSnapshot.h"
+#include "../include/OrderBook.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <thread>
+#include <unistd.h>
+
+SnapshotCapture::SnapshotCapture(OrderBook& book) : book(book) {
+  if (++book.lastCaptureEpoch == 0) ++book.lastCaptureEpoch; // 0 means no capture
+  book.captureEpoch = book.lastCaptureEpoch;
+  book.changedLevels.clear();
+}
+
+SnapshotCapture::~SnapshotCapture() {
+  if (!complete) {
+    book.captureEpoch = 0;
+    book.changedLevels.clear();
+  }
+}
+
+// Copies the level at tick as it is now, or forgets it if it has emptied
+// since. Returns the number of orders copied.
+size_t SnapshotCapture::copyLevel(bool isBuy, size_t tick) {
+  const PriceLevel* level = (isBuy ? book.BuyLevels : book.SellLevels).find(tick);
+  std::map<uint32_t, LevelCopy>& side = isBuy ? bids : asks;
+  auto dropLevel = [&] {
+    const auto it = side.find(static_cast<uint32_t>(tick));
+    if (it != side.end()) {
+      liveOrders -= it->second.count;
+      side.erase(it);
+    }
+  };
+  if (level == nullptr || level->head == nullOrder) {
+    dropLevel();
+    return 0;
+  }
+
+  if (copies.size() >= 2 * liveOrders + 4096) compact(); // Mostly stale copies
+  LevelCopy copy{copies.size(), 0};
+  for (OrderIndex index = level->head; index != nullOrder; index = book.orderPool[index].next) {
+    // The book never keeps an empty order, and restore refuses one; should
+    // one turn up anyway, the image leaves it out rather than become unloadable.
+    const uint32_t quantity = book.orderPool[index].quantity;
+    if (quantity == 0) [[unlikely]] continue;
+    const OrderInfo& info = book.orderPool.info(index);
+    copies.push_back({info.ID, quantity, info.timestamp});
+    copy.count++;
+  }
+  if (copy.count == 0) [[unlikely]] {
+    dropLevel();
+    return 0;
+  }
+  const auto [it, inserted] = side.try_emplace(static_cast<uint32_t>(tick), copy);
+  if (!inserted) {
+    liveOrders -= it->second.count;
+    it->second = copy;
+  }
+  liveOrders += copy.count;
+  return copy.count;
+}
+
+// Drops the stale copies, keeping the live ones in image order.
+void SnapshotCapture::compact() {
+  std::vector<SnapshotOrder> live;
+  live.reserve(liveOrders);
+  auto keep = [&](LevelCopy& copy) {
+    const size_t first = live.size();
+    live.insert(live.end(), copies.begin() + copy.first, copies.begin() + copy.first + copy.count);
+    copy.first = first;
+  };
+  for (auto it = bids.rbegin(); it != bids.rend(); ++it) keep(it->second);
+  for (auto& [price, copy] : asks) keep(copy);
+  copies.swap(live);
+}
+
+bool SnapshotCapture::step(size_t maxOrders) {
+  if (complete) return true;
+  size_t copied = 0;
+
+  // First pass: bids from the best down, then asks from the best up. Levels
+  // the book changes behind the cursors are noted and copied again below.
+  while (!scanned && copied < maxOrders) {
+    const size_t bid = bidsScanned ? PriceLadder::npos : book.BuyLevels.findPrevOccupied(bidCursor);
+    if (bid != PriceLadder::npos) {
+      copied += copyLevel(true, bid);
+      bidsScanned = (bid == 0);
+      bidCursor = bid - 1;
+      continue;
+    }
+    bidsScanned = true;
+    const size_t ask = book.SellLevels.findNextOccupied(askCursor);
+    if (ask != PriceLadder::npos) {
+      copied += copyLevel(false, ask);
+      askCursor = ask + 1;
+      continue;
+    }
+    scanned = true;
+  }
+
+  // Then copy changed levels again, starting a new epoch for each batch, so
+  // that changes made while a batch waits are noted once more.
+  while (scanned && copied < maxOrders) {
+    if (pending.empty()) {
+      if (book.changedLevels.empty()) { // Nothing changed since its copy
+        complete = true;
+        book.captureEpoch = 0;
+        reportSequence = book.reportSequence;
+        return true;
+      }
+      pending.swap(book.changedLevels);
+      if (pending.size() <= Config::snapshotFinalLevels) {
+        // Levels at the touch change with every instruction, so rather than
+        // chase them step after step the last few are copied in this one,
+        // whatever the budget.
+        for (const auto& [isBuy, tick] : pending) copyLevel(isBuy, tick);
+        pending.clear();
+        recopied = true;
+        continue;
+      }
+      if (++book.lastCaptureEpoch == 0) ++book.lastCaptureEpoch;
+      book.captureEpoch = book.lastCaptureEpoch;
+    }
+    const auto [isBuy, tick] = pending.back();
+    pending.pop_back();
+    copied += copyLevel(isBuy, tick);
+    recopied = true;
+  }
+  return false;
+}
+
+BookImage SnapshotCapture::take() {
+  BookImage image;
+  image.bidLevels = static_cast<uint32_t>(bids.size());
+  image.reportSequence = reportSequence;
+  image.levels.reserve(bids.size() + asks.size());
+  for (auto it = bids.rbegin(); it != bids.rend(); ++it) {
+    image.levels.push_back({it->first, it->second.count});
+  }
+  for (const auto& [price, copy] : asks) {
+    image.levels.push_back({price, copy.count});
+  }
+
+  if (!recopied) { // The first pass copied the levels in image order already
+    image.orders = std::move(copies);
+    return image;
+  }
+  size_t total = 0;
+  for (const SnapshotLevel& level : image.levels) total += level.orderCount;
+  image.orders.reserve(total);
+  auto append = [&](const LevelCopy& copy) {
+    image.orders.insert(image.orders.end(), copies.begin() + copy.first, copies.begin() + copy.first + copy.count);
+  };
+  for (auto it = bids.rbegin(); it != bids.rend(); ++it) append(it->second);
+  for (const auto& [price, copy] : asks) append(copy);
+  return image;
+}
+
+namespace {
+
+bool writeAll(int fd, const void* data, size_t bytes, uint64_t offset) {
+  const char* p = static_cast<const char*>(data);
+  while (bytes > 0) {
+    const ssize_t written = pwrite(fd, p, bytes, static_cast<off_t>(offset));
+    if (written <= 0) return false;
+    p += written;
+    bytes -= static_cast<size_t>(written);
+    offset += static_cast<uint64_t>(written);
+  }
+  return true;
+}
+
+uint64_t sectionBytes(const BookImage& image) {
+  const uint64_t bytes = image.levels.size() * sizeof(SnapshotLevel) + image.orders.size() * sizeof(SnapshotOrder);
+  return (bytes + 7) & ~uint64_t{7};
+}
+
+} // namespace
+
+// Written to path.tmp, synced and renamed over path, so that path always
+// holds a complete snapshot.
+bool writeSnapshotFile(const std::string& path, const std::vector<BookImage>& images,
+                       const std::vector<std::string>& names, size_t threads) {
+  SnapshotFileHeader header{};
+  std::memcpy(header.magic, SnapshotFileHeader::expectedMagic, sizeof(header.magic));
+  header.version = SnapshotFileHeader::currentVersion;
+  header.ticksPerUnit = Config::ticksPerUnit;
+  header.levelSize = sizeof(SnapshotLevel);
+  header.orderSize = sizeof(SnapshotOrder);
+  header.sectionCount = static_cast<uint32_t>(images.size());
+
+  std::vector<SnapshotSection> sections(images.size());
+  uint64_t offset = sizeof(header) + sections.size() * sizeof(SnapshotSection);
+  for (size_t i = 0; i < images.size(); ++i) {
+    SnapshotSection& section = sections[i];
+    section.offset = offset;
+    section.orderCount = images[i].orders.size();
+    section.reportSequence = images[i].reportSequence;
+    section.tickerId = static_cast<uint32_t>(i);
+    section.bidLevels = images[i].bidLevels;
+    section.askLevels = static_cast<uint32_t>(images[i].levels.size() - images[i].bidLevels);
+    if (i < names.size()) {
+      std::strncpy(section.name, names[i].c_str(), SnapshotSection::nameSize - 1);
+    }
+    offset += sectionBytes(images[i]);
+  }
+
+  const std::string tmpPath = path + ".tmp";
+  const int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd == -1) return false;
+  bool ok = ftruncate(fd, static_cast<off_t>(offset)) == 0 &&
+            writeAll(fd, &header, sizeof(header), 0) &&
+            writeAll(fd, sections.data(), sections.size() * sizeof(SnapshotSection), sizeof(header));
+
+  // Sections go out in parallel, each with positioned writes of its own.
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = std::min(threads, images.size());
+  std::atomic<size_t> nextSection{0};
+  std::atomic<bool> failed{!ok};
+  auto writeSections = [&]() {
+    for (size_t i; !failed.load(std::memory_order_relaxed) && (i = nextSection.fetch_add(1)) < images.size();) {
+      const BookImage& image = images[i];
+      const size_t levelBytes = image.levels.size() * sizeof(SnapshotLevel);
+      if (!writeAll(fd, image.levels.data(), levelBytes, sections[i].offset) ||
+          !writeAll(fd, image.orders.data(), image.orders.size() * sizeof(SnapshotOrder), sections[i].offset + levelBytes)) {
+        failed.store(true, std::memory_order_relaxed);
+      }
+    }
+  };
+  std::vector<std::thread> writers;
+  for (size_t t = 1; t < threads; ++t) writers.emplace_back(writeSections);
+  writeSections();
+  for (auto& writer : writers) writer.join();
+
+  ok = !failed.load() && fdatasync(fd) == 0;
+  ok = (close(fd) == 0) && ok;
+  if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+    std::remove(tmpPath.c_str());
+    return false;
+  }
+  return true;
+}
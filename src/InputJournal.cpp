@@ -0,0 +1,144 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "../include/InputJournal.h"
+
+namespace {
+
+uint64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool writeAll(int fd, const void* data, size_t bytes) {
+  const char* p = static_cast<const char*>(data);
+  while (bytes > 0) {
+    const ssize_t n = write(fd, p, bytes);
+    if (n <= 0) return false;
+    p += n;
+    bytes -= static_cast<size_t>(n);
+  }
+  return true;
+}
+
+} // namespace
+
+InputJournal::InputJournal(const std::string& path, JournalMode mode, uint32_t shard, uint32_t shardCount,
+                           size_t commitBatch, uint64_t commitIntervalUs)
+  : mode(mode), commitBatch(std::max<size_t>(commitBatch, 1)), commitIntervalNs(commitIntervalUs * 1000),
+    ring(Config::journalRingRecords) {
+  JournalFileHeader header{};
+  std::memcpy(header.magic, JournalFileHeader::expectedMagic, sizeof(header.magic));
+  header.version = JournalFileHeader::currentVersion;
+  header.recordSize = sizeof(JournalRecord);
+  header.ticksPerUnit = Config::ticksPerUnit;
+  header.shard = shard;
+  header.shardCount = shardCount;
+
+  fd = open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_APPEND | O_CLOEXEC, 0644);
+  if (fd == -1 || !writeAll(fd, &header, sizeof(header)) || fdatasync(fd) != 0) {
+    failed.store(true, std::memory_order_relaxed);
+  }
+  writer = std::thread(&InputJournal::run, this);
+}
+
+InputJournal::~InputJournal() {
+  flush();
+  running.store(false, std::memory_order_release);
+  writer.join();
+  if (fd != -1) close(fd);
+}
+
+void InputJournal::appendOverflow(std::span<const Instruction> batch) {
+  overflow.insert(overflow.end(), batch.begin(), batch.end());
+  overflowed++;
+  drainOverflow();
+}
+
+bool InputJournal::drainOverflow() {
+  while (overflowHead < overflow.size()) {
+    // The owner's view of the ring's size can only be too high, so a batch
+    // of this size fits.
+    const size_t room = ring.capacity() - ring.size();
+    const size_t n = std::min(overflow.size() - overflowHead, room);
+    if (n == 0 || !ring.tryPushBatch(overflow.data() + overflowHead, n)) return false;
+    overflowHead += n;
+  }
+  overflow.clear();
+  overflowHead = 0;
+  return true;
+}
+
+void InputJournal::flush() {
+  while (!drainOverflow()) {
+    std::this_thread::yield();
+  }
+  flushRequested.store(appended, std::memory_order_release);
+  while (durable.load(std::memory_order_acquire) < appended && ok()) {
+    std::this_thread::yield();
+  }
+}
+
+void InputJournal::run() {
+  std::vector<Instruction> popped(commitBatch);
+  std::vector<JournalRecord> records(commitBatch);
+  uint64_t sequence = 0;     // Last record written
+  uint64_t synced = 0;       // Last record synced
+  uint64_t oldestUnsyncedNs = 0;
+  size_t idle = 0;
+
+  for (;;) {
+    // Read before popping, so that a stop is only seen once the owner has
+    // appended its last batch and everything it appended gets written.
+    const bool stopping = !running.load(std::memory_order_acquire);
+    const size_t n = ring.popBatch(popped.data(), popped.size());
+    if (n > 0) {
+      for (size_t i = 0; i < n; ++i) {
+        records[i] = {sequence + 1 + i, popped[i]};
+      }
+      if (ok() && !writeAll(fd, records.data(), n * sizeof(JournalRecord))) {
+        failed.store(true, std::memory_order_relaxed);
+      }
+      if (sequence == synced) oldestUnsyncedNs = nowNs();
+      sequence += n;
+      if (ok()) written.store(sequence, std::memory_order_release);
+    }
+
+    const uint64_t requested = flushRequested.load(std::memory_order_acquire);
+    const bool syncDue = sequence > synced &&
+        ((requested > synced && sequence >= requested) ||
+         (mode == JournalMode::GroupCommit &&
+          (sequence - synced >= commitBatch || nowNs() - oldestUnsyncedNs >= commitIntervalNs)));
+    if (syncDue && ok()) {
+      if (fdatasync(fd) == 0) {
+        synced = sequence;
+        durable.store(synced, std::memory_order_release);
+        syncCount.fetch_add(1, std::memory_order_relaxed);
+      } else {
+        failed.store(true, std::memory_order_relaxed);
+      }
+    }
+
+    if (n > 0) {
+      idle = 0;
+    } else if (stopping) {
+      break;
+    } else if (++idle < Config::shardIdleSpins) {
+#if defined(__x86_64__) || defined(__i386__)
+      __builtin_ia32_pause();
+#endif
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
@@ -0,0 +1,217 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+
+#include "../include/InstructionParser.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PARSER_HAS_X86 1
+#endif
+
+#ifdef PARSER_HAS_X86
+namespace {
+
+// Lines are located a 64-byte block at a time; a line that does not end
+// inside the block starting at it goes to parseInstructionLine.
+constexpr size_t blockBytes = 64;
+
+// Stage 1: bit i of semicolons / newlines is set when p[i] is a ';' / '\n',
+// for the 64 bytes at p. One implementation per instruction set.
+struct Delimiters {
+  uint64_t semicolons;
+  uint64_t newlines;
+};
+using IndexFn = Delimiters (*)(const char* p);
+
+// Byte compares rather than PCMPESTRM: the string instructions return one
+// combined mask at a much higher latency, and the two sets are needed apart.
+__attribute__((target("sse4.2")))
+Delimiters indexSse42(const char* p) {
+  const __m128i semicolon = _mm_set1_epi8(';');
+  const __m128i newline = _mm_set1_epi8('\n');
+  Delimiters d{0, 0};
+  for (size_t i = 0; i < blockBytes; i += 16) {
+    __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+    d.semicolons |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(data, semicolon)))) << i;
+    d.newlines |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(data, newline)))) << i;
+  }
+  return d;
+}
+
+__attribute__((target("avx2")))
+Delimiters indexAvx2(const char* p) {
+  const __m256i semicolon = _mm256_set1_epi8(';');
+  const __m256i newline = _mm256_set1_epi8('\n');
+  __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+  uint32_t semicolonsLo = _mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, semicolon));
+  uint32_t semicolonsHi = _mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, semicolon));
+  uint32_t newlinesLo = _mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, newline));
+  uint32_t newlinesHi = _mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, newline));
+  return {(static_cast<uint64_t>(semicolonsHi) << 32) | semicolonsLo,
+          (static_cast<uint64_t>(newlinesHi) << 32) | newlinesLo};
+}
+
+// The first len (1 to 8) ASCII digits of the bytes in v, in memory order.
+// The bytes after them are shifted out, and in their place the low, leading
+// bytes read as zero digits.
+inline uint64_t swarDigits(uint64_t v, size_t len) {
+  v = (v - 0x3030303030303030) << (8 * (8 - len));
+  v = (v * 10) + (v >> 8);
+  v = (((v & 0x000000FF000000FF) * (100 + (1000000ULL << 32))) +
+       (((v >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32)))) >> 32;
+  return v;
+}
+
+// len (1 to 8) digits at p in one load; reads 8 bytes whatever len is.
+inline uint64_t parseEightDigits(const char* p, size_t len) {
+  uint64_t v;
+  std::memcpy(&v, p, 8);
+  return swarDigits(v, len);
+}
+
+// A field of 1 to 16 digits, its length already known from the delimiters.
+inline uint64_t parseDigits(const char* p, size_t len) {
+  if (len <= 8) return parseEightDigits(p, len);
+  return parseEightDigits(p, len - 8) * 100'000'000 + parseEightDigits(p + len - 8, 8);
+}
+
+// A price of 2 to 8 characters, rounded to ticks like fast_atoticks. Any '.'
+// is squeezed out so that whole and fraction digits are read together, and
+// the fraction is scaled to eight digits so that rounding divides by a
+// constant.
+inline uint32_t parsePriceTicks(const char* p, size_t len) {
+  static constexpr uint64_t pow10[] = {1, 10, 100, 1000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000};
+  uint64_t v;
+  std::memcpy(&v, p, 8);
+  const uint64_t x = v ^ 0x2E2E2E2E2E2E2E2E; // Zero byte where v has a '.'
+  const uint64_t dots = (x - 0x0101010101010101) & ~x & 0x8080808080808080;
+  const size_t dot = std::countr_zero(dots) / 8;
+  if (dot >= len) {
+    return checkedTicks(swarDigits(v, len) * Config::ticksPerUnit);
+  }
+  const uint64_t below = (uint64_t{1} << (8 * dot)) - 1;
+  v = (v & below) | ((v >> 8) & ~below);
+  const size_t fractionLength = len - dot - 1;
+  return checkedTicks((swarDigits(v, len - 1) * pow10[8 - fractionLength] * Config::ticksPerUnit + 50'000'000) / 100'000'000);
+}
+
+// Stage 2: the line at p, given the delimiters of the block starting at it.
+// Returns the line length including its '\n', or 0 if the line is not one the
+// fast path takes: six ';', one-character side and type fields, numeric
+// fields of the lengths the SWAR decoders handle, and a '\n' at least 8 bytes
+// before the end of the block. Every field starts before the '\n', so the
+// 8-byte loads of the SWAR decoders stay inside the block.
+inline size_t decodeLine(const char* p, Delimiters block, uint16_t tickerId, Instruction& out, bool& accepted) {
+  if (block.newlines == 0) return 0;
+  const uint32_t newline = std::countr_zero(block.newlines);
+  if (newline + 8 > blockBytes) return 0;
+  uint64_t semicolons = block.semicolons & ((uint64_t{1} << newline) - 1);
+  if (std::popcount(semicolons) != 6) return 0;
+
+  uint32_t d[6];
+  for (uint32_t& offset : d) {
+    offset = std::countr_zero(semicolons);
+    semicolons &= semicolons - 1;
+  }
+  const size_t timestampLength = newline - d[5] - 1 - (p[newline - 1] == '\r'); // CRLF line ending
+  if (d[0] - 1 >= 16 || d[2] != d[1] + 2 || d[3] - d[2] - 3 >= 7 || d[4] - d[3] - 2 >= 16 ||
+      d[5] != d[4] + 2 || timestampLength - 1 >= 16) {
+    return 0;
+  }
+
+  out = {parseDigits(p + d[5] + 1, timestampLength),
+         static_cast<uint32_t>(parseDigits(p, d[0])),
+         parsePriceTicks(p + d[2] + 1, d[3] - d[2] - 1),
+         static_cast<uint32_t>(parseDigits(p + d[3] + 1, d[4] - d[3] - 1)),
+         tickerId, InstructionAction::Add, 0};
+  accepted = setInstructionType(p[d[4] + 1], p[d[1] + 1] == 'B', out);
+  return newline + 1;
+}
+
+// Always inlined, so that each instruction set's entry point below compiles
+// the loop, index() included, for its own target.
+template <IndexFn index>
+[[gnu::always_inline]] inline size_t parseWith(const char*& p, const char* end, uint16_t tickerId, Instruction* out, size_t maxOut, size_t& skipped) {
+  size_t n = 0;
+  while (n < maxOut && p < end) {
+    bool accepted;
+    size_t length = 0;
+    // A whole block must be readable; decodeLine keeps the SWAR decoders'
+    // loads inside it.
+    if (static_cast<size_t>(end - p) >= blockBytes) {
+      length = decodeLine(p, index(p), tickerId, out[n], accepted);
+    }
+    if (length != 0) {
+      p += length;
+    } else {
+      accepted = parseInstructionLine(p, end, tickerId, out[n]);
+    }
+    n += accepted;
+    skipped += !accepted;
+  }
+  return n;
+}
+
+__attribute__((target("sse4.2")))
+size_t parseSse42(const char*& p, const char* end, uint16_t tickerId, Instruction* out, size_t maxOut, size_t& skipped) {
+  return parseWith<indexSse42>(p, end, tickerId, out, maxOut, skipped);
+}
+
+__attribute__((target("avx2")))
+size_t parseAvx2(const char*& p, const char* end, uint16_t tickerId, Instruction* out, size_t maxOut, size_t& skipped) {
+  return parseWith<indexAvx2>(p, end, tickerId, out, maxOut, skipped);
+}
+
+} // namespace
+#endif
+
+ParserIsa detectParserIsa() {
+#ifdef PARSER_HAS_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) return ParserIsa::Avx2;
+  if (__builtin_cpu_supports("sse4.2")) return ParserIsa::Sse42;
+#endif
+  return ParserIsa::Scalar;
+}
+
+const char* parserIsaName(ParserIsa isa) {
+  switch (isa) {
+  case ParserIsa::Avx2: return "avx2";
+  case ParserIsa::Sse42: return "sse4.2";
+  default: return "scalar";
+  }
+}
+
+size_t parseInstructions(ParserIsa isa, const char*& p, const char* end, uint16_t tickerId,
+                         Instruction* out, size_t maxOut, size_t& skipped) {
+  switch (isa) {
+#ifdef PARSER_HAS_X86
+  case ParserIsa::Avx2:
+    return parseAvx2(p, end, tickerId, out, maxOut, skipped);
+  case ParserIsa::Sse42:
+    return parseSse42(p, end, tickerId, out, maxOut, skipped);
+#endif
+  default:
+    break;
+  }
+  // Scalar: a block of compares done a byte at a time costs more than the
+  // line-at-a-time decoder, which stops at each delimiter as it reaches it.
+  size_t n = 0;
+  while (n < maxOut && p < end) {
+    if (parseInstructionLine(p, end, tickerId, out[n])) {
+      n++;
+    } else {
+      skipped++;
+    }
+  }
+  return n;
+}
@@ -0,0 +1,56 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include "../include/L2Book.h"
+
+bool L2Book::apply(const LevelUpdate& update) {
+  if (isStale) return false;
+  if (update.sequence < expected) return true; // In the snapshot already
+  if (update.sequence != expected) {
+    isStale = true;
+    return false;
+  }
+  expected++;
+
+  auto set = [&](auto& side) {
+    if (update.orderCount == 0) {
+      side.erase(update.price);
+    } else {
+      side[update.price] = {update.price, update.quantity, update.orderCount};
+    }
+  };
+  if (update.isBuy) {
+    set(bids);
+  } else {
+    set(asks);
+  }
+  return true;
+}
+
+void L2Book::resync(const DepthSnapshot& snapshot) {
+  bids.clear();
+  asks.clear();
+  for (const DepthLevel& level : snapshot.bids) bids.emplace(level.price, level);
+  for (const DepthLevel& level : snapshot.asks) asks.emplace(level.price, level);
+  expected = snapshot.sequence;
+  isStale = false;
+}
+
+size_t L2Book::getDepth(bool isBuy, size_t nLevels, DepthLevel* out) const {
+  size_t written = 0;
+  auto copy = [&](const auto& side) {
+    for (auto it = side.begin(); it != side.end() && written < nLevels; ++it) {
+      out[written++] = it->second;
+    }
+  };
+  if (isBuy) {
+    copy(bids);
+  } else {
+    copy(asks);
+  }
+  return written;
+}
@@ -5,34 +5,156 @@
 //                                                                               //
 // ----------------------------------------------------------------------------- //
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
 #include <vector>
 
 #include "../include/MatchingEngine.h"
 #include "../include/Configuration.h"
+#include "../include/Price.h"
 
-MatchingEngine::MatchingEngine() {
-    orderBooks.resize(Config::tickers.size());
-    tickerIdToNameMap.resize(Config::tickers.size());
-    for (size_t i = 0; i < Config::tickers.size(); ++i) {
-        orderBooks[i] = std::make_unique<OrderBook>();
+MatchingEngine::MatchingEngine() : MatchingEngine(Config::tickers.size()) {}
+
+MatchingEngine::MatchingEngine(size_t bookCount) {
+    orderBooks.resize(bookCount);
+    tickerIdToNameMap.resize(bookCount);
+    for (size_t i = 0; i < bookCount; ++i) {
+        orderBooks[i] = std::make_unique<OrderBook>(arena);
+        if (Config::orderPoolPrewarmOrders > 0) {
+            orderBooks[i]->reserve(Config::orderPoolPrewarmOrders);
+        }
     }
 }
 
-void MatchingEngine::processOrders(uint32_t tickerId, bool isBuy, double price, uint32_t quantity, uint32_t timestamp, uint32_t ID) {
-  if (tickerId >= orderBooks.size()) return;
-  orderBooks[tickerId]->processOrders(isBuy, price, quantity, timestamp, ID, tickerId);
+uint32_t MatchingEngine::addTicker(const std::string& tickerName) {
+  const uint32_t tickerId = static_cast<uint32_t>(orderBooks.size());
+  orderBooks.push_back(std::make_unique<OrderBook>(arena));
+  if (Config::orderPoolPrewarmOrders > 0) {
+    orderBooks.back()->reserve(Config::orderPoolPrewarmOrders);
+  }
+  tickerIdToNameMap.push_back(tickerName);
+  return tickerId;
+}
+
+ExecutionSummary MatchingEngine::processOrders(uint32_t tickerId, bool isBuy, uint32_t price, uint32_t quantity, uint32_t timestamp, uint32_t ID) {
+  if (tickerId >= orderBooks.size()) return {};
+  OrderBook& book = *orderBooks[tickerId];
+  const ExecutionSummary summary = book.processOrders(isBuy, price, quantity, timestamp, ID);
+  book.publishMarketData();
+  return summary;
+}
+
+ExecutionSummary MatchingEngine::processOrders(uint32_t tickerId, OrderType type, bool isBuy, uint32_t price, uint32_t quantity, uint32_t timestamp, uint32_t ID) {
+  if (tickerId >= orderBooks.size()) return {};
+  OrderBook& book = *orderBooks[tickerId];
+  const ExecutionSummary summary = book.processOrders(type, isBuy, price, quantity, timestamp, ID);
+  book.publishMarketData();
+  return summary;
 }
 bool MatchingEngine::cancelOrder(uint32_t tickerId, uint32_t ID) {
   if (tickerId >= orderBooks.size() || !orderBooks[tickerId]) return false;
-  return orderBooks[tickerId]->cancelOrder(ID);
+  const bool cancelled = orderBooks[tickerId]->cancelOrder(ID);
+  orderBooks[tickerId]->publishMarketData();
+  return cancelled;
 }
 
-bool MatchingEngine::editOrder(uint32_t tickerId, uint32_t ID, double newPrice, uint32_t newQuantity) {
+bool MatchingEngine::editOrder(uint32_t tickerId, uint32_t ID, uint32_t newPrice, uint32_t newQuantity) {
   if (tickerId >= orderBooks.size() || !orderBooks[tickerId]) return false;
-  return orderBooks[tickerId]->editOrder(ID, newPrice, newQuantity);
+  const bool edited = orderBooks[tickerId]->editOrder(ID, newPrice, newQuantity);
+  orderBooks[tickerId]->publishMarketData();
+  return edited;
+}
+
+ExecutionSummary MatchingEngine::processOrdersAtPrice(uint32_t tickerId, bool isBuy, double price, uint32_t quantity, uint32_t timestamp, uint32_t ID) {
+  return processOrders(tickerId, isBuy, priceToTicks(price), quantity, timestamp, ID);
+}
+
+bool MatchingEngine::editOrderAtPrice(uint32_t tickerId, uint32_t ID, double newPrice, uint32_t newQuantity) {
+  return editOrder(tickerId, ID, priceToTicks(newPrice), newQuantity);
+}
+
+InstructionResult MatchingEngine::execute(const Instruction& instruction) {
+  InstructionResult result{};
+  if (instruction.tickerId >= orderBooks.size()) return result;
+  OrderBook& book = *orderBooks[instruction.tickerId];
+  const uint32_t timestamp = static_cast<uint32_t>(instruction.timestamp);
+
+  switch (instruction.action) {
+  case InstructionAction::Add:
+    if (instruction.orderType() == OrderType::Limit) {
+      result.summary = book.processOrders(instruction.isBuy(), instruction.price, instruction.quantity, timestamp, instruction.ID);
+    } else {
+      result.summary = book.processOrders(instruction.orderType(), instruction.isBuy(), instruction.price,
+                                          instruction.quantity, timestamp, instruction.ID);
+    }
+    result.accepted = true;
+    break;
+  case InstructionAction::Cancel:
+    result.accepted = book.cancelOrder(instruction.ID);
+    break;
+  case InstructionAction::Edit:
+    result.accepted = book.editOrder(instruction.ID, instruction.price, instruction.quantity);
+    break;
+  }
+  return result;
+}
+
+size_t MatchingEngine::processBatch(std::span<const Instruction> batch, std::span<InstructionResult> results) {
+  constexpr size_t distance = Config::batchPrefetchDistance;
+  const size_t n = std::min(batch.size(), results.size());
+
+  auto touchesOrder = [&](const Instruction& instruction) {
+    return instruction.action != InstructionAction::Add && instruction.tickerId < orderBooks.size();
+  };
+
+  // Each book the batch touches publishes its level updates and top of book
+  // once, after its last instruction. A book belongs to one thread at a time
+  // (see BookScheduler), so its mark can live in the book and the list on
+  // this thread's stack; a batch touching more books than the list holds
+  // publishes early.
+  OrderBook* touched[Config::maxInstructionBatchSize];
+  size_t touchedCount = 0;
+  auto publishTouched = [&] {
+    for (size_t t = 0; t < touchedCount; ++t) {
+      touched[t]->publishPending = false;
+      touched[t]->publishMarketData();
+    }
+    touchedCount = 0;
+  };
+
+  for (size_t i = 0; i < n; ++i) {
+    if constexpr (distance > 0) {
+      if (i + 2 * distance < n && touchesOrder(batch[i + 2 * distance])) {
+        const Instruction& ahead = batch[i + 2 * distance];
+        orderBooks[ahead.tickerId]->prefetchIndex(ahead.ID);
+      }
+      if (i + distance < n && touchesOrder(batch[i + distance])) {
+        const Instruction& ahead = batch[i + distance];
+        orderBooks[ahead.tickerId]->prefetchOrder(ahead.ID);
+      }
+    }
+    results[i] = execute(batch[i]);
+    if (batch[i].tickerId < orderBooks.size()) {
+      OrderBook& book = *orderBooks[batch[i].tickerId];
+      if (!book.publishPending) {
+        if (touchedCount == std::size(touched)) publishTouched();
+        book.publishPending = true;
+        touched[touchedCount++] = &book;
+      }
+    }
+  }
+  publishTouched();
+  return n;
 }
 
 void MatchingEngine::setTickerName(uint32_t tickerId, const std::string& tickerName) {
@@ -45,6 +167,138 @@ const OrderBook* MatchingEngine::getOrderBook(uint32_t tickerId) const {
   return orderBooks[tickerId].get();
 }
 
+size_t MatchingEngine::pollExecutionReports(uint32_t tickerId, ExecutionReport* out, size_t maxReports) {
+  if (tickerId >= orderBooks.size() || !orderBooks[tickerId]) return 0;
+  return orderBooks[tickerId]->executionReports().popBatch(out, maxReports);
+}
+
+size_t MatchingEngine::pollLevelUpdates(uint32_t tickerId, LevelUpdate* out, size_t maxUpdates) {
+  if (tickerId >= orderBooks.size() || !orderBooks[tickerId]) return 0;
+  return orderBooks[tickerId]->levelUpdateRing().popBatch(out, maxUpdates);
+}
+
+TopOfBook MatchingEngine::getBBO(uint32_t tickerId) const {
+  if (tickerId >= orderBooks.size() || !orderBooks[tickerId]) return {};
+  return orderBooks[tickerId]->getBBO();
+}
+
+size_t MatchingEngine::pendingLevelUpdates(uint32_t tickerId) const {
+  if (tickerId >= orderBooks.size() || !orderBooks[tickerId]) return 0;
+  return orderBooks[tickerId]->levelUpdateRing().size();
+}
+
+void MatchingEngine::setLevelUpdateMode(uint32_t tickerId, LevelUpdateMode mode) {
+  if (tickerId >= orderBooks.size() || !orderBooks[tickerId]) return;
+  orderBooks[tickerId]->setLevelUpdateMode(mode);
+}
+
+DepthSnapshot MatchingEngine::depthSnapshot(uint32_t tickerId) {
+  if (tickerId >= orderBooks.size() || !orderBooks[tickerId]) return {};
+  return orderBooks[tickerId]->depthSnapshot();
+}
+
+size_t MatchingEngine::getDepth(uint32_t tickerId, bool isBuy, size_t nLevels, DepthLevel* out) const {
+  if (tickerId >= orderBooks.size() || !orderBooks[tickerId]) return 0;
+  return orderBooks[tickerId]->getDepth(isBuy, nLevels, out);
+}
+
+bool MatchingEngine::writeSnapshot(const std::string& path, size_t threads) {
+  std::vector<BookImage> images(orderBooks.size());
+  for (size_t i = 0; i < orderBooks.size(); ++i) {
+    if (orderBooks[i]) images[i] = orderBooks[i]->snapshot();
+  }
+  return writeSnapshotFile(path, images, tickerIdToNameMap, threads);
+}
+
+bool MatchingEngine::restoreSnapshot(const std::string& path, size_t threads) {
+  const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) return false;
+  struct stat st;
+  const size_t size = (fstat(fd, &st) == 0) ? static_cast<size_t>(st.st_size) : 0;
+  void* mapping = (size >= sizeof(SnapshotFileHeader)) ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+  close(fd);
+  if (mapping == MAP_FAILED) return false;
+  // One advice per call: the values are not flags.
+  madvise(mapping, size, MADV_SEQUENTIAL);
+  madvise(mapping, size, MADV_WILLNEED);
+  const char* file = static_cast<const char*>(mapping);
+
+  // Everything is checked against the file size before any book is touched.
+  SnapshotFileHeader header;
+  std::memcpy(&header, file, sizeof(header));
+  bool ok = std::memcmp(header.magic, SnapshotFileHeader::expectedMagic, sizeof(header.magic)) == 0 &&
+            header.version == SnapshotFileHeader::currentVersion &&
+            header.ticksPerUnit == Config::ticksPerUnit &&
+            header.levelSize == sizeof(SnapshotLevel) && header.orderSize == sizeof(SnapshotOrder) &&
+            (size - sizeof(header)) / sizeof(SnapshotSection) >= header.sectionCount;
+  const SnapshotSection* sections = reinterpret_cast<const SnapshotSection*>(file + sizeof(header));
+  std::vector<bool> seen; // No two sections may restore the same book
+  for (uint32_t i = 0; ok && i < header.sectionCount; ++i) {
+    const SnapshotSection& section = sections[i];
+    const uint64_t levels = uint64_t{section.bidLevels} + section.askLevels;
+    ok = section.offset % 8 == 0 && section.offset <= size &&
+         section.orderCount <= size / sizeof(SnapshotOrder) &&
+         levels * sizeof(SnapshotLevel) + section.orderCount * sizeof(SnapshotOrder) <= size - section.offset &&
+         section.tickerId <= UINT16_MAX &&
+         (section.tickerId >= orderBooks.size() || !orderBooks[section.tickerId] || orderBooks[section.tickerId]->orderCount() == 0);
+    if (ok) {
+      if (seen.size() <= section.tickerId) seen.resize(section.tickerId + 1);
+      ok = !seen[section.tickerId];
+      seen[section.tickerId] = true;
+    }
+  }
+  if (!ok) {
+    munmap(mapping, size);
+    return false;
+  }
+
+  for (uint32_t i = 0; i < header.sectionCount; ++i) {
+    const SnapshotSection& section = sections[i];
+    while (orderBooks.size() <= section.tickerId) {
+      addTicker("");
+    }
+    if (!orderBooks[section.tickerId]) orderBooks[section.tickerId] = std::make_unique<OrderBook>(arena);
+    const std::string name(section.name, strnlen(section.name, SnapshotSection::nameSize));
+    if (!name.empty()) tickerIdToNameMap[section.tickerId] = name;
+  }
+
+  // Sections are independent books, so they are restored in parallel, each
+  // reading its records straight from the mapping.
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = std::min<size_t>(threads, header.sectionCount);
+  std::atomic<uint32_t> nextSection{0};
+  std::atomic<bool> failed{false};
+  auto restoreSections = [&]() {
+    for (uint32_t i; (i = nextSection.fetch_add(1)) < header.sectionCount;) {
+      const SnapshotSection& section = sections[i];
+      BookImageView image;
+      image.levels = {reinterpret_cast<const SnapshotLevel*>(file + section.offset), section.bidLevels + size_t{section.askLevels}};
+      image.orders = {reinterpret_cast<const SnapshotOrder*>(file + section.offset + image.levels.size_bytes()), section.orderCount};
+      image.bidLevels = section.bidLevels;
+      image.reportSequence = section.reportSequence;
+      if (!orderBooks[section.tickerId]->restore(image)) failed.store(true, std::memory_order_relaxed);
+    }
+  };
+  std::vector<std::thread> workers;
+  for (size_t t = 1; t < threads; ++t) workers.emplace_back(restoreSections);
+  restoreSections();
+  for (auto& worker : workers) worker.join();
+
+  munmap(mapping, size);
+  return !failed.load();
+}
+
+size_t MatchingEngine::bookMemoryUsage(uint32_t tickerId) const {
+  if (tickerId >= orderBooks.size() || !orderBooks[tickerId]) return 0;
+  return orderBooks[tickerId]->memoryUsage();
+}
+
+void MatchingEngine::shrinkToFit() {
+  for (auto& book : orderBooks) {
+    if (book) book->shrinkToFit();
+  }
+}
+
 void MatchingEngine::printAllHistograms(int blockSize) const {
   std::cout << "\n--- Final Order Book State ---\n";
   for (size_t i = 0; i < orderBooks.size(); ++i) {
@@ -8,177 +8,319 @@
 
 #include "../include/OrderBook.h"
 #include "../include/Configuration.h"
+#include "../include/Price.h"
 #include <iomanip>
 #include <iostream>
 #include <algorithm>
 
-OrderBook::OrderBook() : orderPool() {
+OrderBook::OrderBook(SlabArena& arena)
+  : orderPool(arena), reports(Config::emitExecutionReports ? Config::executionReportRingSize : 0),
+    levelUpdates(Config::levelUpdateRingSize) {
   bestBidIndex = -1;
   bestAskIndex = -1;
-  BuyHeads.resize(Config::priceLevels, nullptr);
-  BuyTails.resize(Config::priceLevels, nullptr);
-  SellHeads.resize(Config::priceLevels, nullptr);
-  SellTails.resize(Config::priceLevels, nullptr);
 }
 
 void OrderBook::updateBestBid() {
-  for (int i = bestBidIndex; i >= 0; --i) {
-    if (BuyHeads[i] != nullptr) {
-      bestBidIndex = i;
-      return;
-    }
-  }
-  bestBidIndex = -1; // No bids left
+  size_t i = BuyLevels.findPrevOccupied(bestBidIndex == -1 ? 0 : bestBidIndex);
+  bestBidIndex = (i == PriceLadder::npos) ? -1 : static_cast<int>(i); // -1 if no bids left
 }
 
 void OrderBook::updateBestAsk() {
-  for (size_t i = (bestAskIndex == -1) ? 0 : bestAskIndex; i < Config::priceLevels; ++i) {
-    if (SellHeads[i] != nullptr) {
-      bestAskIndex = i;
-      return;
-    }
+  size_t i = SellLevels.findNextOccupied(bestAskIndex == -1 ? 0 : bestAskIndex);
+  bestAskIndex = (i == PriceLadder::npos) ? -1 : static_cast<int>(i); // -1 if no asks left
+}
+
+// Appends an unlinked order to the queue at its price
+void OrderBook::addOrderToList(OrderIndex orderIndex) {
+  Order& order = orderPool[orderIndex];
+  size_t index = order.price;
+  PriceLadder& levels = order.isBuy ? BuyLevels : SellLevels;
+  PriceLevel& level = levels.acquire(index);
+  noteLevelChange(order.isBuy, index, level);
+
+  if (level.tail != nullOrder) {
+    orderPool[level.tail].next = orderIndex;
+    order.prev = level.tail;
+  }
+  level.tail = orderIndex;
+  if (level.head == nullOrder) {
+    level.head = orderIndex;
+    levels.markOccupied(index);
+  }
+  level.totalQuantity += order.quantity;
+  level.orderCount++;
+  levelChanged(order.isBuy, index, level);
+
+  if (order.isBuy) {
+    if (bestBidIndex == -1 || index > static_cast<size_t>(bestBidIndex)) bestBidIndex = index;
+  } else {
+    if (bestAskIndex == -1 || index < static_cast<size_t>(bestAskIndex)) bestAskIndex = index;
   }
-  bestAskIndex = -1; // No asks left
 }
 
 // Helper to remove an order from its linked list
-void OrderBook::removeOrderFromList(Order* order) {
-  size_t index = priceToIndex(order->price);
-  Order** head = order->isBuy ? &BuyHeads[index] : &SellHeads[index];
-  Order** tail = order->isBuy ? &BuyTails[index] : &SellTails[index];
-
-  if (order->prev) {
-    order->prev->next = order->next;
+void OrderBook::removeOrderFromList(OrderIndex orderIndex) {
+  Order& order = orderPool[orderIndex];
+  size_t index = order.price;
+  PriceLevel& level = order.isBuy ? BuyLevels.levelAt(index) : SellLevels.levelAt(index);
+  noteLevelChange(order.isBuy, index, level);
+
+  if (order.prev != nullOrder) {
+    orderPool[order.prev].next = order.next;
   } else { // This was the head
-    *head = order->next;
+    level.head = order.next;
   }
 
-  if (order->next) {
-    order->next->prev = order->prev;
+  if (order.next != nullOrder) {
+    orderPool[order.next].prev = order.prev;
   } else { // This was the tail
-    *tail = order->prev;
+    level.tail = order.prev;
   }
 
-  order->next = nullptr;
-  order->prev = nullptr;
+  order.next = nullOrder;
+  order.prev = nullOrder;
+  level.totalQuantity -= order.quantity;
+  level.orderCount--;
+  levelChanged(order.isBuy, index, level);
 
   // Update best bid/ask if the removed order was at the best level and it's now empty
-  if (*head == nullptr) { // List became empty
-    if (order->isBuy && static_cast<int>(index) == bestBidIndex) {
-      updateBestBid();
-    } else if (!order->isBuy && static_cast<int>(index) == bestAskIndex) {
-      updateBestAsk();
+  if (level.head == nullOrder) { // List became empty
+    if (order.isBuy) {
+      BuyLevels.markEmpty(index);
+      if (static_cast<int>(index) == bestBidIndex) updateBestBid();
+    } else {
+      SellLevels.markEmpty(index);
+      if (static_cast<int>(index) == bestAskIndex) updateBestAsk();
     }
   }
 }
 
-void OrderBook::processBuyMatching(uint32_t& quantity, size_t index) {
-  while (quantity > 0 && bestAskIndex != -1 && index >= static_cast<size_t>(bestAskIndex)) {
-    Order* sellOrder = SellHeads[bestAskIndex];
+void OrderBook::emitReport(uint32_t aggressorId, uint32_t restingId, uint32_t price, uint32_t quantity,
+                           uint32_t aggressorRemaining, uint32_t restingRemaining) {
+  ExecutionReport report{reportSequence++, aggressorId, restingId, price, quantity, aggressorRemaining, restingRemaining};
+  if (!reports.tryPush(report)) {
+    droppedReports++;
+  }
+}
 
-    if (quantity < sellOrder->quantity) {
-      sellOrder->quantity -= quantity;
+void OrderBook::processBuyMatching(uint32_t& quantity, size_t index, uint32_t ID, ExecutionSummary& summary) {
+  while (quantity > 0 && bestAskIndex != -1 && index >= static_cast<size_t>(bestAskIndex)) {
+    PriceLevel& level = SellLevels.levelAt(bestAskIndex);
+    OrderIndex sellIndex = level.head;
+    Order& sellOrder = orderPool[sellIndex];
+    summary.fills++;
+
+    if (quantity < sellOrder.quantity) {
+      noteLevelChange(false, bestAskIndex, level);
+      sellOrder.quantity -= quantity;
+      level.totalQuantity -= quantity;
+      levelChanged(false, bestAskIndex, level);
+      summary.filledQuantity += quantity;
+      if constexpr (Config::emitExecutionReports) {
+        emitReport(ID, orderPool.info(sellIndex).ID, sellOrder.price, quantity, 0, sellOrder.quantity);
+      }
       quantity = 0;
     } else {
-      quantity -= sellOrder->quantity;
-      orderMap.erase(sellOrder->ID);
-      removeOrderFromList(sellOrder);
-      orderPool.deallocate(sellOrder);
+      quantity -= sellOrder.quantity;
+      summary.filledQuantity += sellOrder.quantity;
+      if constexpr (Config::emitExecutionReports) {
+        emitReport(ID, orderPool.info(sellIndex).ID, sellOrder.price, sellOrder.quantity, quantity, 0);
+      }
+      orderMap.erase(orderPool.info(sellIndex).ID);
+      removeOrderFromList(sellIndex);
+      orderPool.deallocate(sellIndex);
     }
   }
 }
 
-void OrderBook::processSellMatching(uint32_t& quantity, size_t index) {
+void OrderBook::processSellMatching(uint32_t& quantity, size_t index, uint32_t ID, ExecutionSummary& summary) {
   while (quantity > 0 && bestBidIndex != -1 && index <= static_cast<size_t>(bestBidIndex)) {
-    Order* buyOrder = BuyHeads[bestBidIndex];
-
-    if (quantity < buyOrder->quantity) {
-      buyOrder->quantity -= quantity;
+    PriceLevel& level = BuyLevels.levelAt(bestBidIndex);
+    OrderIndex buyIndex = level.head;
+    Order& buyOrder = orderPool[buyIndex];
+    summary.fills++;
+
+    if (quantity < buyOrder.quantity) {
+      noteLevelChange(true, bestBidIndex, level);
+      buyOrder.quantity -= quantity;
+      level.totalQuantity -= quantity;
+      levelChanged(true, bestBidIndex, level);
+      summary.filledQuantity += quantity;
+      if constexpr (Config::emitExecutionReports) {
+        emitReport(ID, orderPool.info(buyIndex).ID, buyOrder.price, quantity, 0, buyOrder.quantity);
+      }
       quantity = 0;
     } else {
-      quantity -= buyOrder->quantity;
-      orderMap.erase(buyOrder->ID);
-      removeOrderFromList(buyOrder);
-      orderPool.deallocate(buyOrder);
+      quantity -= buyOrder.quantity;
+      summary.filledQuantity += buyOrder.quantity;
+      if constexpr (Config::emitExecutionReports) {
+        emitReport(ID, orderPool.info(buyIndex).ID, buyOrder.price, buyOrder.quantity, quantity, 0);
+      }
+      orderMap.erase(orderPool.info(buyIndex).ID);
+      removeOrderFromList(buyIndex);
+      orderPool.deallocate(buyIndex);
     }
   }
 }
 
-void OrderBook::processOrders(bool isBuy, double price, uint32_t quantity, uint32_t timestamp, uint32_t ID, uint32_t tickerId) {
-  if (price < Config::minPrice || price > (Config::minPrice + (Config::priceLevels - 1) * Config::tickSize)) {
-    return; // Price is out of the supported range
+// Whether the opposite side holds at least quantity at index or better. Sums
+// level aggregates over occupied levels only, never walks an order queue.
+bool OrderBook::canFill(bool isBuy, size_t index, uint32_t quantity) const {
+  uint64_t available = 0;
+  if (isBuy) {
+    size_t i = (bestAskIndex == -1) ? PriceLadder::npos : static_cast<size_t>(bestAskIndex);
+    while (i != PriceLadder::npos && i <= index) {
+      available += SellLevels.levelAt(i).totalQuantity;
+      if (available >= quantity) return true;
+      i = SellLevels.findNextOccupied(i + 1);
+    }
+  } else {
+    size_t i = (bestBidIndex == -1) ? PriceLadder::npos : static_cast<size_t>(bestBidIndex);
+    while (i != PriceLadder::npos && i >= index) {
+      available += BuyLevels.levelAt(i).totalQuantity;
+      if (available >= quantity) return true;
+      i = (i == 0) ? PriceLadder::npos : BuyLevels.findPrevOccupied(i - 1);
+    }
   }
-  size_t index = priceToIndex(price);
+  return false;
+}
 
-  if (isBuy) {
-    processBuyMatching(quantity, index);
-    if (quantity > 0) {
-      Order* newOrder = orderPool.allocate(timestamp, isBuy, price, quantity, ID, tickerId);
-      if (BuyTails[index] != nullptr) {
-        BuyTails[index]->next = newOrder;
-        newOrder->prev = BuyTails[index];
-      }
-      BuyTails[index] = newOrder;
-      if (BuyHeads[index] == nullptr) {
-        BuyHeads[index] = newOrder;
-      }
-      orderMap[ID] = newOrder;
-      if (bestBidIndex == -1 || index > static_cast<size_t>(bestBidIndex)) {
-        bestBidIndex = index;
-      }
+template <OrderType Type>
+ExecutionSummary OrderBook::processOrder(bool isBuy, uint32_t price, uint32_t quantity, uint32_t timestamp, uint32_t ID) {
+  constexpr bool rests = (Type == OrderType::Limit || Type == OrderType::PostOnly);
+  ExecutionSummary summary;
+
+  if constexpr (Type == OrderType::Market) {
+    price = isBuy ? static_cast<uint32_t>(Config::maxPriceTicks - 1) : 0; // Any price will do
+  } else if (price >= Config::maxPriceTicks) {
+    summary.cancelledQuantity = quantity;
+    return summary; // Price is out of the supported range
+  }
+  size_t index = price;
+
+  if constexpr (Type == OrderType::FillOrKill) {
+    if (!canFill(isBuy, index, quantity)) {
+      summary.cancelledQuantity = quantity;
+      return summary;
     }
-  } else { // Sell
-    processSellMatching(quantity, index);
-    if (quantity > 0) {
-      Order* newOrder = orderPool.allocate(timestamp, isBuy, price, quantity, ID, tickerId);
-      if (SellTails[index] != nullptr) {
-        SellTails[index]->next = newOrder;
-        newOrder->prev = SellTails[index];
-      }
-      SellTails[index] = newOrder;
-      if (SellHeads[index] == nullptr) {
-        SellHeads[index] = newOrder;
-      }
-      orderMap[ID] = newOrder;
-      if (bestAskIndex == -1 || index < static_cast<size_t>(bestAskIndex)) {
-        bestAskIndex = index;
-      }
+  }
+  if constexpr (Type == OrderType::PostOnly) {
+    bool crosses = isBuy ? (bestAskIndex != -1 && index >= static_cast<size_t>(bestAskIndex))
+                         : (bestBidIndex != -1 && index <= static_cast<size_t>(bestBidIndex));
+    if (crosses) {
+      summary.cancelledQuantity = quantity;
+      return summary;
+    }
+  }
+
+  if constexpr (Type != OrderType::PostOnly) {
+    if (isBuy) {
+      processBuyMatching(quantity, index, ID, summary);
+    } else {
+      processSellMatching(quantity, index, ID, summary);
     }
   }
+  if (rests && quantity > 0) {
+    OrderIndex newIndex = orderPool.allocate(timestamp, isBuy, price, quantity, ID);
+    addOrderToList(newIndex);
+    orderMap.insert(ID, newIndex);
+  }
+
+  if constexpr (rests) {
+    summary.restingQuantity = quantity;
+  } else {
+    summary.cancelledQuantity = quantity;
+  }
+  return summary;
+}
+
+ExecutionSummary OrderBook::processOrders(bool isBuy, uint32_t price, uint32_t quantity, uint32_t timestamp, uint32_t ID) {
+  return processOrder<OrderType::Limit>(isBuy, price, quantity, timestamp, ID);
+}
+
+ExecutionSummary OrderBook::processOrders(OrderType type, bool isBuy, uint32_t price, uint32_t quantity, uint32_t timestamp, uint32_t ID) {
+  switch (type) {
+  case OrderType::Limit:
+    return processOrder<OrderType::Limit>(isBuy, price, quantity, timestamp, ID);
+  case OrderType::ImmediateOrCancel:
+    return processOrder<OrderType::ImmediateOrCancel>(isBuy, price, quantity, timestamp, ID);
+  case OrderType::FillOrKill:
+    return processOrder<OrderType::FillOrKill>(isBuy, price, quantity, timestamp, ID);
+  case OrderType::Market:
+    return processOrder<OrderType::Market>(isBuy, price, quantity, timestamp, ID);
+  case OrderType::PostOnly:
+    return processOrder<OrderType::PostOnly>(isBuy, price, quantity, timestamp, ID);
+  }
+  return {};
 }
 
 bool OrderBook::cancelOrder(uint32_t ID) {
-  Order** order_ptr = orderMap.find(ID); 
+  OrderIndex* order_ptr = orderMap.find(ID);
   if (order_ptr == nullptr) {
     return false; // Order not found
   }
 
-  Order* order = *order_ptr;
-  removeOrderFromList(order);
+  OrderIndex orderIndex = *order_ptr;
+  removeOrderFromList(orderIndex);
   orderMap.erase(ID);
-  orderPool.deallocate(order);
+  orderPool.deallocate(orderIndex);
 
   return true;
 }
 
-bool OrderBook::editOrder(uint32_t ID, double newPrice, uint32_t newQuantity) {
-  Order** order_ptr = orderMap.find(ID);
+// Amends in place with a single index lookup. An amend to quantity 0 is a
+// cancel. A quantity-down at the same price keeps queue priority. Any other
+// amend moves the order to the back of the queue at its new price, matching
+// first if that price is marketable, and keeps both its pool slot and its
+// index entry unless it fills entirely.
+bool OrderBook::editOrder(uint32_t ID, uint32_t newPrice, uint32_t newQuantity) {
+  OrderIndex* order_ptr = orderMap.find(ID);
   if (order_ptr == nullptr) {
     return false; // Order not found
   }
 
-  Order* order = *order_ptr;
+  OrderIndex orderIndex = *order_ptr;
+  Order& order = orderPool[orderIndex];
+
+  if (newQuantity == 0) { // Nothing left to rest, at any price
+    removeOrderFromList(orderIndex);
+    orderMap.erase(ID);
+    orderPool.deallocate(orderIndex);
+    return true;
+  }
+
+  if (order.price == newPrice && newQuantity <= order.quantity) {
+    PriceLevel& level = order.isBuy ? BuyLevels.levelAt(newPrice) : SellLevels.levelAt(newPrice);
+    noteLevelChange(order.isBuy, newPrice, level);
+    level.totalQuantity -= order.quantity - newQuantity;
+    order.quantity = newQuantity;
+    levelChanged(order.isBuy, newPrice, level);
+    return true;
+  }
 
-  if (order->price != newPrice || newQuantity > order->quantity) {
-    bool isBuy = order->isBuy;
-    uint32_t timestamp = order->timestamp;
-    uint32_t tickerId = order->tickerId;
+  removeOrderFromList(orderIndex);
+  if (newPrice >= Config::maxPriceTicks) { // Unsupported price, the order is gone
+    orderMap.erase(ID);
+    orderPool.deallocate(orderIndex);
+    return true;
+  }
 
-    cancelOrder(ID);
-    processOrders(isBuy, newPrice, newQuantity, timestamp, ID, tickerId);
+  uint32_t quantity = newQuantity;
+  ExecutionSummary summary; // Fills still go out as execution reports
+  if (order.isBuy) {
+    processBuyMatching(quantity, newPrice, ID, summary); // No-op unless marketable
   } else {
-    order->quantity = newQuantity;
+    processSellMatching(quantity, newPrice, ID, summary);
+  }
+
+  if (quantity == 0) { // Filled on the way to its new price
+    orderMap.erase(ID);
+    orderPool.deallocate(orderIndex);
+    return true;
   }
+  order.price = newPrice;
+  order.quantity = quantity;
+  addOrderToList(orderIndex);
   return true;
 }
 
@@ -193,35 +335,22 @@ void OrderBook::printOrderBookHistogram(const std::string& tickerName, int block
   std::cout << "|       BUY ORDERS       |   PRICE   |       SELL ORDERS      |\n";
   std::cout << "+------------------------+-----------+------------------------+\n";
 
-  int max_level = 0;
-  if (bestBidIndex != -1) max_level = std::max(max_level, bestBidIndex);
+  int max_level = -1;
+  int min_level = 0;
+  if (bestBidIndex != -1) {
+    max_level = bestBidIndex;
+    min_level = static_cast<int>(BuyLevels.lowestOccupied());
+  }
   if (bestAskIndex != -1) {
-    for (int i = Config::priceLevels - 1; i >= bestAskIndex; --i) {
-      if (SellHeads[i] != nullptr) {
-        max_level = std::max(max_level, i);
-        break;
-      }
-    }
+    max_level = std::max(max_level, static_cast<int>(SellLevels.highestOccupied()));
+    min_level = (bestBidIndex == -1) ? bestAskIndex : std::min(min_level, bestAskIndex);
   }
 
-  for (int i = max_level; i >= 0; --i) {
-    uint64_t buy_quantity = 0;
-    if (BuyHeads[i] != nullptr) {
-      Order* current = BuyHeads[i];
-      while(current != nullptr) {
-        buy_quantity += current->quantity;
-        current = current->next;
-      }
-    }
-
-    uint64_t sell_quantity = 0;
-    if (i < (int)Config::priceLevels && SellHeads[i] != nullptr) {
-      Order* current = SellHeads[i];
-      while(current != nullptr) {
-        sell_quantity += current->quantity;
-        current = current->next;
-      }
-    }
+  for (int i = max_level; i >= min_level; --i) {
+    const PriceLevel* buy_level = BuyLevels.find(i);
+    const PriceLevel* sell_level = SellLevels.find(i);
+    uint64_t buy_quantity = buy_level ? buy_level->totalQuantity : 0;
+    uint64_t sell_quantity = sell_level ? sell_level->totalQuantity : 0;
 
     if (buy_quantity == 0 && sell_quantity == 0) {
       continue;
@@ -238,7 +367,7 @@ void OrderBook::printOrderBookHistogram(const std::string& tickerName, int block
     std::cout << RESET << " |";
 
     // Price
-    std::cout << std::setw(10) << indexToPrice(i) << " | ";
+    std::cout << std::setw(10) << ticksToPrice(i) << " | ";
 
     // Sell side
     std::cout << RED;
@@ -253,3 +382,159 @@ void OrderBook::printOrderBookHistogram(const std::string& tickerName, int block
 
   std::cout << "+------------------------+-----------+------------------------+\n";
 }
+
+size_t OrderBook::getDepth(bool isBuy, size_t nLevels, DepthLevel* out) const {
+  const PriceLadder& levels = isBuy ? BuyLevels : SellLevels;
+  int best = isBuy ? bestBidIndex : bestAskIndex;
+
+  size_t written = 0;
+  size_t i = (best == -1) ? PriceLadder::npos : static_cast<size_t>(best);
+  while (written < nLevels && i != PriceLadder::npos) {
+    const PriceLevel& level = levels.levelAt(i);
+    out[written++] = {static_cast<uint32_t>(i), level.totalQuantity, level.orderCount};
+    if (isBuy) {
+      i = (i == 0) ? PriceLadder::npos : levels.findPrevOccupied(i - 1);
+    } else {
+      i = levels.findNextOccupied(i + 1);
+    }
+  }
+  return written;
+}
+
+void OrderBook::emitLevelUpdate(bool isBuy, size_t tick, uint64_t quantity, uint32_t orderCount) {
+  const LevelUpdate update{levelUpdateSequence++, quantity, static_cast<uint32_t>(tick), orderCount, isBuy};
+  if (!levelUpdates.tryPush(update)) {
+    droppedLevelUpdates++;
+  }
+}
+
+void OrderBook::flushLevelUpdates() {
+  for (const LevelUpdate& update : conflatedUpdates) {
+    emitLevelUpdate(update.isBuy, update.price, update.quantity, update.orderCount);
+  }
+  conflatedUpdates.clear();
+}
+
+void OrderBook::publishTopOfBook() {
+  TopOfBook top;
+  if (bestBidIndex != -1) {
+    const PriceLevel& level = BuyLevels.levelAt(bestBidIndex);
+    top.bidPrice = static_cast<uint32_t>(bestBidIndex);
+    top.bidQuantity = level.totalQuantity;
+    top.bidOrders = level.orderCount;
+  }
+  if (bestAskIndex != -1) {
+    const PriceLevel& level = SellLevels.levelAt(bestAskIndex);
+    top.askPrice = static_cast<uint32_t>(bestAskIndex);
+    top.askQuantity = level.totalQuantity;
+    top.askOrders = level.orderCount;
+  }
+  // Most operations leave the top alone; readers then keep their cached line.
+  if (top == publishedTop) return;
+  publishedTop = top;
+  topOfBook.write(top);
+}
+
+void OrderBook::setLevelUpdateMode(LevelUpdateMode mode) {
+  publishLevelUpdates();
+  levelUpdateMode = mode;
+}
+
+DepthSnapshot OrderBook::depthSnapshot() {
+  publishLevelUpdates();
+  DepthSnapshot snapshot;
+  snapshot.sequence = levelUpdateSequence;
+  for (size_t i = (bestBidIndex == -1) ? PriceLadder::npos : static_cast<size_t>(bestBidIndex); i != PriceLadder::npos;
+       i = (i == 0) ? PriceLadder::npos : BuyLevels.findPrevOccupied(i - 1)) {
+    const PriceLevel& level = BuyLevels.levelAt(i);
+    snapshot.bids.push_back({static_cast<uint32_t>(i), level.totalQuantity, level.orderCount});
+  }
+  for (size_t i = (bestAskIndex == -1) ? PriceLadder::npos : static_cast<size_t>(bestAskIndex); i != PriceLadder::npos;
+       i = SellLevels.findNextOccupied(i + 1)) {
+    const PriceLevel& level = SellLevels.levelAt(i);
+    snapshot.asks.push_back({static_cast<uint32_t>(i), level.totalQuantity, level.orderCount});
+  }
+  return snapshot;
+}
+
+size_t OrderBook::memoryUsage() const {
+  return sizeof(*this) + orderPool.memoryUsage() + orderMap.memoryUsage() + ladderMemoryUsage() +
+         reports.capacity() * sizeof(ExecutionReport) + levelUpdates.capacity() * sizeof(LevelUpdate) +
+         conflatedUpdates.capacity() * sizeof(LevelUpdate);
+}
+
+void OrderBook::shrinkToFit() {
+  orderPool.shrink();
+  orderMap.shrinkToFit();
+  BuyLevels.shrinkToFit();
+  SellLevels.shrinkToFit();
+}
+
+void OrderBook::recordLevelChange(bool isBuy, size_t tick, PriceLevel& level) {
+  level.captureEpoch = captureEpoch;
+  changedLevels.emplace_back(isBuy, static_cast<uint32_t>(tick));
+}
+
+BookImage OrderBook::snapshot() {
+  SnapshotCapture capture(*this);
+  capture.step(SIZE_MAX);
+  return capture.take();
+}
+
+bool OrderBook::restore(const BookImageView& image) {
+  if (orderMap.size() != 0 || image.bidLevels > image.levels.size()) return false;
+  uint64_t expected = 0;
+  for (size_t i = 0; i < image.levels.size(); ++i) {
+    const SnapshotLevel& level = image.levels[i];
+    if (level.price >= Config::maxPriceTicks || level.orderCount == 0) return false;
+    if (i > 0 && i != image.bidLevels) { // Each level worse than the one before
+      const uint32_t previous = image.levels[i - 1].price;
+      if (i < image.bidLevels ? level.price >= previous : level.price <= previous) return false;
+    }
+    expected += level.orderCount;
+  }
+  if (expected != image.orders.size()) return false;
+  if (image.bidLevels > 0 && image.bidLevels < image.levels.size() &&
+      image.levels[0].price >= image.levels[image.bidLevels].price) {
+    return false; // Crossed
+  }
+  for (const SnapshotOrder& order : image.orders) {
+    if (order.quantity == 0) return false;
+  }
+
+  // Each queue is linked as its orders are allocated, in order, rather than
+  // appended one order at a time.
+  orderMap.reserve(image.orders.size());
+  const SnapshotOrder* order = image.orders.data();
+  for (size_t i = 0; i < image.levels.size(); ++i) {
+    const bool isBuy = i < image.bidLevels;
+    const uint32_t price = image.levels[i].price;
+    PriceLadder& levels = isBuy ? BuyLevels : SellLevels;
+    PriceLevel& level = levels.acquire(price);
+    OrderIndex previous = nullOrder;
+    for (uint32_t n = 0; n < image.levels[i].orderCount; ++n, ++order) {
+      const OrderIndex index = orderPool.allocate(order->timestamp, isBuy, price, order->quantity, order->ID);
+      if (previous == nullOrder) {
+        level.head = index;
+      } else {
+        orderPool[previous].next = index;
+        orderPool[index].prev = previous;
+      }
+      previous = index;
+      level.totalQuantity += order->quantity;
+      orderMap.insert(order->ID, index);
+    }
+    level.tail = previous;
+    level.orderCount = image.levels[i].orderCount;
+    levels.markOccupied(price);
+    // The book was empty, so a consumer in step with it holds an empty copy
+    // and takes the restored depth as one update per level.
+    levelChanged(isBuy, price, level);
+  }
+
+  bestBidIndex = (image.bidLevels > 0) ? static_cast<int>(image.levels[0].price) : -1;
+  bestAskIndex = (image.bidLevels < image.levels.size()) ? static_cast<int>(image.levels[image.bidLevels].price) : -1;
+  reportSequence = image.reportSequence;
+  publishMarketData();
+  return true;
+}
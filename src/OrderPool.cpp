@@ -7,41 +7,129 @@
 
 
 #include "../include/OrderPool.h"
-#include "../include/Configuration.h"
 
-OrderPool::OrderPool() {
-  memory_chunks.reserve(16);
-  free_list.reserve(Config::orderPoolChunkSize);
+#include <cstring>
+
+OrderPool::~OrderPool() {
+  for (SlabArena::Slab* slab : slabs) {
+    if (slab) arena->release(slab);
+  }
 }
 
-void OrderPool::grow() {
-  auto new_chunk = std::make_unique<std::vector<Order>>(Config::orderPoolChunkSize);
-  for (auto& order : *new_chunk) {
-    free_list.push_back(&order);
+uint32_t OrderPool::newSlab() {
+  uint32_t slab;
+  if (!vacant.empty()) {
+    slab = vacant.back();
+    vacant.pop_back();
+  } else {
+    slab = static_cast<uint32_t>(slabs.size());
+    slabs.push_back(nullptr);
+    use.emplace_back();
   }
-  memory_chunks.push_back(std::move(new_chunk));
+  slabs[slab] = arena->acquire();
+  use[slab] = SlabUse{};
+  held++;
+  return slab;
+}
+
+void OrderPool::releaseSlab(uint32_t slab) {
+  arena->release(slabs[slab]);
+  slabs[slab] = nullptr;
+  use[slab] = SlabUse{};
+  vacant.push_back(slab);
+  held--;
 }
 
-Order* OrderPool::allocate(uint32_t timestamp, bool isBuy, double price, uint32_t quantity, uint32_t ID, uint32_t tickerId) {
-  if (free_list.empty()) {
-    grow();
+// A slab with free slots: a partly used one if there is one, so that emptied
+// slabs can drain, otherwise a new one.
+uint32_t OrderPool::takeSlab() {
+  while (!available.empty()) {
+    const uint32_t slab = available.back();
+    available.pop_back();
+    if (!slabs[slab] || !use[slab].listed) continue; // Handed back, or already taken since
+    use[slab].listed = false;
+    if (!full(use[slab])) return slab;
   }
+  return newSlab();
+}
+
+// Current is full: park its use and start filling another slab.
+void OrderPool::switchSlab() {
+  if (current != noSlab) use[current] = filling;
+  current = takeSlab();
+  filling = use[current];
+}
 
-  Order* order = free_list.back();
-  free_list.pop_back();
+void OrderPool::reserve(size_t n) {
+  for (size_t reserved = 0; reserved < n; reserved += SlabArena::slabOrders) {
+    const uint32_t slab = newSlab();
+    std::memset(static_cast<void*>(slabs[slab]), 0, sizeof(SlabArena::Slab));
+    use[slab].listed = true;
+    available.push_back(slab);
+  }
+}
 
-  order->price = price;
-  order->ID = ID;
-  order->tickerId = tickerId;
-  order->timestamp = timestamp;
-  order->quantity = quantity;
-  order->isBuy = isBuy;
-  order->next = nullptr;
-  order->prev = nullptr;
+void OrderPool::shrink() {
+  if (current != noSlab && filling.live == 0) {
+    releaseSlab(current);
+    current = noSlab;
+    filling = SlabUse{nullOrder, SlabArena::slabOrders, 0, false};
+  }
+}
 
-  return order;
+OrderIndex OrderPool::allocate(uint32_t timestamp, bool isBuy, uint32_t price, uint32_t quantity, uint32_t ID) {
+  if (full(filling)) {
+    switchSlab();
+  }
+
+  OrderIndex index = filling.free_head;
+  if (index != nullOrder) {
+    filling.free_head = (*this)[index].next;
+  } else {
+    index = (static_cast<OrderIndex>(current) << slabShift) + filling.next_unused++;
+  }
+  filling.live++;
+
+  Order& order = (*this)[index];
+  order.price = price;
+  order.quantity = quantity;
+  order.isBuy = isBuy;
+  order.next = nullOrder;
+  order.prev = nullOrder;
+
+  OrderInfo& orderInfo = info(index);
+  orderInfo.ID = ID;
+  orderInfo.timestamp = timestamp;
+
+  return index;
+}
+
+void OrderPool::deallocate(OrderIndex index) {
+  if ((index >> slabShift) != current) {
+    releaseElsewhere(index);
+    return;
+  }
+  (*this)[index].next = filling.free_head;
+  filling.free_head = index;
+  filling.live--;
+}
+
+// Releases a slot of a slab other than current, handing the slab back once
+// it is empty. Kept out of line so that deallocate() stays a leaf.
+[[gnu::noinline]] void OrderPool::releaseElsewhere(OrderIndex index) {
+  const uint32_t slab = index >> slabShift;
+  SlabUse& slabUse = use[slab];
+  (*this)[index].next = slabUse.free_head;
+  slabUse.free_head = index;
+  if (--slabUse.live == 0) {
+    releaseSlab(slab);
+  } else if (!slabUse.listed) {
+    slabUse.listed = true;
+    available.push_back(slab);
+  }
 }
 
-void OrderPool::deallocate(Order* order) {
-  free_list.push_back(order);
+size_t OrderPool::memoryUsage() const {
+  return held * sizeof(SlabArena::Slab) + slabs.capacity() * sizeof(slabs[0]) + use.capacity() * sizeof(use[0]) +
+         (available.capacity() + vacant.capacity()) * sizeof(uint32_t);
 }
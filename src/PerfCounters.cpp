@@ -0,0 +1,134 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include "../include/PerfCounters.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::atomic<int> firstOpenError{0};
+
+#ifdef __linux__
+
+struct EventSpec {
+  uint32_t type;
+  uint64_t config;
+};
+
+constexpr uint64_t cacheEvent(uint64_t cache, uint64_t op, uint64_t result) {
+  return cache | (op << 8) | (result << 16);
+}
+
+// Indexed by PerfEvent.
+constexpr EventSpec eventSpecs[PerfEventCount] = {
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+  {PERF_TYPE_HW_CACHE, cacheEvent(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+  {PERF_TYPE_HW_CACHE, cacheEvent(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+int openEvent(const EventSpec& spec) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = spec.type;
+  attr.config = spec.config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1; // Allowed up to perf_event_paranoid 2
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+  if (fd < 0) {
+    int expected = 0;
+    firstOpenError.compare_exchange_strong(expected, errno, std::memory_order_relaxed);
+  }
+  return fd;
+}
+
+#endif
+
+} // namespace
+
+PerfCounters::PerfCounters() {
+  fds.fill(-1);
+#ifdef __linux__
+  for (size_t i = 0; i < PerfEventCount; ++i) {
+    fds[i] = openEvent(eventSpecs[i]);
+  }
+#else
+  int expected = 0;
+  firstOpenError.compare_exchange_strong(expected, ENOSYS, std::memory_order_relaxed);
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+  for (int fd : fds) {
+    if (fd >= 0) close(fd);
+  }
+#endif
+}
+
+bool PerfCounters::available() const {
+  for (int fd : fds) {
+    if (fd >= 0) return true;
+  }
+  return false;
+}
+
+void PerfCounters::start() {
+#ifdef __linux__
+  for (int fd : fds) {
+    if (fd < 0) continue;
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+#endif
+}
+
+PerfCounts PerfCounters::stop() {
+  PerfCounts counts;
+#ifdef __linux__
+  for (int fd : fds) {
+    if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+  }
+  for (size_t i = 0; i < PerfEventCount; ++i) {
+    if (fds[i] < 0) continue;
+    uint64_t data[3]; // value, time enabled, time running
+    if (read(fds[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) continue;
+    counts.values[i] = (data[2] < data[1])
+        ? static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2])
+        : data[0];
+    counts.valid[i] = true;
+  }
+#endif
+  return counts;
+}
+
+const char* PerfCounters::name(PerfEvent event) {
+  static constexpr const char* names[PerfEventCount] = {
+    "cycles", "instructions", "l1d_misses", "llc_misses", "dtlb_misses", "branch_misses"
+  };
+  return names[event];
+}
+
+const char* PerfCounters::openError() {
+  const int error = firstOpenError.load(std::memory_order_relaxed);
+  return error ? std::strerror(error) : nullptr;
+}
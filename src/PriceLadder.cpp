@@ -0,0 +1,98 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <algorithm>
+
+#include "../include/PriceLadder.h"
+
+void PriceLadder::grow(size_t tick) {
+  const size_t tickPage = tick >> pageShift;
+
+  if (empty()) {
+    // Nothing rests on this side, so every page has been released already:
+    // re-anchor the window around the incoming price instead of stretching it.
+    const size_t half = Config::ladderInitialPages / 2;
+    const size_t firstPage = (tickPage > half) ? tickPage - half : 0;
+    pages.clear();
+    pages.resize(Config::ladderInitialPages);
+    baseTick = firstPage << pageShift;
+    occupied.resize(pages.size() << pageShift);
+    return;
+  }
+
+  // Rebuild the window around the occupied range plus the new price, with as
+  // much slack again toward the new price. Pages outside the occupied range
+  // have already been released, so a window left trailing behind a trending
+  // market is dropped here instead of growing forever, and a drifting market
+  // still costs amortised O(1) per page crossed.
+  const size_t firstPage = baseTick >> pageShift;
+  size_t newFirstPage = std::min(lowestOccupied() >> pageShift, tickPage);
+  size_t newEndPage = std::max(highestOccupied() >> pageShift, tickPage) + 1;
+  const size_t slack = std::max(newEndPage - newFirstPage, Config::ladderInitialPages);
+  if (tickPage < firstPage) {
+    newFirstPage = (newFirstPage > slack) ? newFirstPage - slack : 0;
+  } else {
+    newEndPage += slack;
+  }
+
+  std::vector<std::unique_ptr<Page>> newPages(newEndPage - newFirstPage);
+  for (size_t i = 0; i < pages.size(); ++i) {
+    if (pages[i]) {
+      newPages[firstPage + i - newFirstPage] = std::move(pages[i]);
+    }
+  }
+
+  const size_t newBaseTick = newFirstPage << pageShift;
+  LevelBitmap newOccupied(newPages.size() << pageShift);
+  for (size_t rel = occupied.findFirst(); rel != npos; rel = occupied.findNextSet(rel + 1)) {
+    newOccupied.set(rel + baseTick - newBaseTick);
+  }
+
+  pages = std::move(newPages);
+  occupied = std::move(newOccupied);
+  baseTick = newBaseTick;
+}
+
+void PriceLadder::allocatePage(std::unique_ptr<Page>& slot) {
+  if (sparePage) {
+    // The spare's levels are empty but may still carry the epoch of a capture
+    // that noted them at their old prices; cleared, the first change at the
+    // new prices is noted again.
+    slot = std::move(sparePage);
+    for (PriceLevel& level : slot->levels) level.captureEpoch = 0;
+  } else {
+    slot = std::make_unique<Page>();
+  }
+  residentPages++;
+}
+
+void PriceLadder::releasePage(std::unique_ptr<Page>& slot) {
+  // Every level of the page is empty again, so it can be reused.
+  if (!sparePage) {
+    sparePage = std::move(slot);
+  } else {
+    slot.reset();
+  }
+  residentPages--;
+}
+
+size_t PriceLadder::memoryUsage() const {
+  size_t bytes = pages.capacity() * sizeof(pages[0]);
+  bytes += occupied.size() / 8;
+  bytes += (residentPages + (sparePage ? 1 : 0)) * sizeof(Page);
+  return bytes;
+}
+
+void PriceLadder::shrinkToFit() {
+  sparePage.reset();
+  if (empty()) {
+    pages.clear();
+    pages.shrink_to_fit();
+    occupied = LevelBitmap();
+    baseTick = 0;
+  }
+}
@@ -13,6 +13,100 @@
 
 #include "../include/Reporting.h"
 #include "../include/Configuration.h"
+#include "../include/Tsc.h"
+
+// Hardware counters per replayed instruction, one row per ticker, so they
+// line up with the rows above. Explains itself when perf events are missing.
+static void print_perf_table(const std::vector<TickerResult>& results) {
+    if (results.empty()) return; // No replay ran, so nothing was counted
+    PerfCounts total;
+    for (const auto& r : results) total.merge(r.perf);
+    if (!total.any()) {
+        const char* reason = PerfCounters::openError();
+        std::cout << "\nHardware counters: unavailable" << (reason ? std::string(" (") + reason + ")" : std::string())
+                  << "; check /proc/sys/kernel/perf_event_paranoid, or the PMU is not exposed to this machine\n";
+        return;
+    }
+
+    const char* rule = "+----------+----------+----------+--------+----------+----------+----------+----------+\n";
+    std::cout << "\nHardware counters per instruction:\n" << rule;
+    std::cout << "|  TICKER  |  CYCLES  |  INSTRS  |  IPC   | L1D MISS | LLC MISS | DTLB MIS | BR MISS  |\n" << rule;
+
+    auto print_row = [](const std::string& label, const PerfCounts& perf, long long instructions) {
+        std::cout << "| " << std::setw(8) << std::left << label << std::right;
+        const double n = instructions > 0 ? static_cast<double>(instructions) : 1.0;
+        auto cell = [&](PerfEvent event, int width) {
+            std::cout << " | " << std::setw(width);
+            if (perf.valid[event]) std::cout << perf.values[event] / n; else std::cout << "n/a";
+        };
+        cell(PerfCycles, 8);
+        cell(PerfInstructions, 8);
+        std::cout << " | " << std::setw(6);
+        if (perf.valid[PerfCycles] && perf.valid[PerfInstructions] && perf.values[PerfCycles] > 0) {
+            std::cout << static_cast<double>(perf.values[PerfInstructions]) / perf.values[PerfCycles];
+        } else {
+            std::cout << "n/a";
+        }
+        cell(PerfL1dMisses, 8);
+        cell(PerfLlcMisses, 8);
+        cell(PerfDtlbMisses, 8);
+        cell(PerfBranchMisses, 8);
+        std::cout << " |\n";
+    };
+
+    long long total_instructions = 0;
+    for (const auto& r : results) {
+        print_row(r.name, r.perf, r.instruction_count);
+        total_instructions += r.instruction_count;
+    }
+    std::cout << rule;
+    print_row("TOTAL", total, total_instructions);
+    std::cout << rule;
+}
+
+// One row of the latency table: sample count, then percentiles in ns.
+static void print_latency_row(const std::string& label, const LatencyHistogram& histogram, double ns_per_tick) {
+    std::cout << "| " << std::setw(10) << std::left << label << " | "
+              << std::setw(12) << std::right << histogram.count();
+    for (double percentile : {50.0, 90.0, 99.0, 99.9}) {
+        std::cout << " | " << std::setw(9) << histogram.valueAtPercentile(percentile) * ns_per_tick;
+    }
+    std::cout << " | " << std::setw(11) << histogram.max() * ns_per_tick << " |\n";
+}
+
+// Per-ticker and per-type percentiles, merging the histograms each replay
+// thread kept for its ticker.
+static void print_latency_table(const std::vector<TickerResult>& results) {
+    const double ns_per_tick = tscNanosPerTick();
+    const char* rule = "+------------+--------------+-----------+-----------+-----------+-----------+-------------+\n";
+    std::cout << "\nLatency per instruction (ns):\n" << rule;
+    std::cout << "|            |    COUNT     |    p50    |    p90    |    p99    |   p99.9   |     MAX     |\n" << rule;
+
+    std::vector<LatencyHistogram> by_kind(LatencyKindCount);
+    LatencyHistogram all;
+    for (const auto& r : results) {
+        if (r.latency.size() != LatencyKindCount) continue;
+        LatencyHistogram ticker;
+        for (size_t kind = 0; kind < LatencyKindCount; ++kind) {
+            ticker.merge(r.latency[kind]);
+            by_kind[kind].merge(r.latency[kind]);
+        }
+        print_latency_row(r.name, ticker, ns_per_tick);
+        all.merge(ticker);
+    }
+    std::cout << rule;
+
+    const char* kind_names[LatencyKindCount] = {"ADD rest", "ADD match", "CANCEL", "EDIT"};
+    LatencyHistogram adds = by_kind[AddRestLatency];
+    adds.merge(by_kind[AddMatchLatency]);
+    print_latency_row("ADD", adds, ns_per_tick);
+    for (size_t kind = 0; kind < LatencyKindCount; ++kind) {
+        print_latency_row(kind_names[kind], by_kind[kind], ns_per_tick);
+    }
+    std::cout << rule;
+    print_latency_row("TOTAL", all, ns_per_tick);
+    std::cout << rule;
+}
 
 void print_table(const std::vector<TickerResult>& results) {
     std::cout << std::fixed << std::setprecision(2);
@@ -64,4 +158,10 @@ void print_table(const std::vector<TickerResult>& results) {
     std::cout << "\nSummary:\n";
     std::cout << "  Instructions/sec: " << instructions_per_second / 1e6 << " M/s\n";
     std::cout << "  Avg. Latency/Inst: " << latency_ns << " ns\n";
-}
\ No newline at end of file
+
+    print_perf_table(results);
+
+    if constexpr (Config::recordLatencyHistograms) {
+        print_latency_table(results);
+    }
+}
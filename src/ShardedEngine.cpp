@@ -0,0 +1,149 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <pthread.h>
+#include <sched.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <span>
+#include <string>
+
+#include "../include/ShardedEngine.h"
+#include "../include/Configuration.h"
+
+namespace {
+
+uint64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#endif
+}
+
+bool pinCurrentThread(int cpu) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+} // namespace
+
+ShardedEngine::ShardedEngine(size_t shardCount, std::vector<int> cpus) {
+  shardCount = std::max<size_t>(shardCount, 1);
+  shards.reserve(shardCount);
+  for (size_t i = 0; i < shardCount; ++i) {
+    shards.push_back(std::make_unique<Shard>(Config::shardQueueCapacity));
+    if (!cpus.empty()) shards[i]->cpu = cpus[i % cpus.size()];
+  }
+}
+
+ShardedEngine::~ShardedEngine() {
+  stop();
+}
+
+bool ShardedEngine::enableJournal(const std::string& directory, JournalMode mode) {
+  if (running.load()) return false;
+  auto pathOf = [&](size_t shard) { return directory + "/shard-" + std::to_string(shard) + ".journal"; };
+  for (size_t i = 0; i < shards.size(); ++i) {
+    shards[i]->journal = std::make_unique<InputJournal>(pathOf(i), mode, static_cast<uint32_t>(i), static_cast<uint32_t>(shards.size()));
+    if (!shards[i]->journal->ok()) {
+      for (size_t j = 0; j <= i; ++j) shards[j]->journal.reset();
+      for (size_t j = 0; j < i; ++j) std::remove(pathOf(j).c_str()); // Only the ones created here
+      return false;
+    }
+  }
+  return true;
+}
+
+void ShardedEngine::start() {
+  if (running.exchange(true)) return;
+  for (auto& shard : shards) {
+    shard->worker = std::thread(&ShardedEngine::run, this, std::ref(*shard));
+  }
+}
+
+void ShardedEngine::stop() {
+  if (!running.exchange(false)) return;
+  for (auto& shard : shards) {
+    shard->worker.join();
+    if (shard->journal) shard->journal->flush();
+  }
+}
+
+bool ShardedEngine::submit(const Instruction& instruction) {
+  if (instruction.tickerId >= matchingEngine.bookCount()) return false;
+  Shard& shard = *shards[shardOf(instruction.tickerId)];
+  if (shard.queue.tryPush({instruction, nowNs()})) return true;
+  shard.rejectedSubmits.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+ShardedEngine::ShardStats ShardedEngine::stats(size_t shard) const {
+  const Shard& s = *shards[shard];
+  return {s.processed.load(std::memory_order_relaxed),
+          s.accepted.load(std::memory_order_relaxed),
+          s.rejectedSubmits.load(std::memory_order_relaxed),
+          s.queueLatencyNsTotal.load(std::memory_order_relaxed),
+          s.queueLatencyNsMax.load(std::memory_order_relaxed),
+          s.journalOverflows.load(std::memory_order_relaxed)};
+}
+
+void ShardedEngine::run(Shard& shard) {
+  if (shard.cpu >= 0) shard.pinned.store(pinCurrentThread(shard.cpu), std::memory_order_relaxed);
+
+  Request requests[Config::instructionBatchSize];
+  Instruction batch[Config::instructionBatchSize];
+  InstructionResult results[Config::instructionBatchSize];
+  uint64_t processed = 0, accepted = 0, latencyTotal = 0, latencyMax = 0;
+  size_t idle = 0;
+
+  for (;;) {
+    const size_t n = shard.queue.popBatch(requests, Config::instructionBatchSize);
+    if (n == 0) {
+      // Exit only once stopped and empty; a push claimed before stop() may
+      // still be being written.
+      if (!running.load(std::memory_order_acquire) && shard.queue.size() == 0) break;
+      if (++idle < Config::shardIdleSpins) {
+        cpuRelax();
+      } else {
+        std::this_thread::yield();
+      }
+      continue;
+    }
+    idle = 0;
+
+    const uint64_t now = nowNs();
+    for (size_t i = 0; i < n; ++i) {
+      const uint64_t latency = now - std::min(now, requests[i].submitNs);
+      latencyTotal += latency;
+      latencyMax = std::max(latencyMax, latency);
+      batch[i] = requests[i].instruction;
+    }
+    // Write-ahead: a batch is only matched once its journal has taken it,
+    // into memory if the disk is behind; matching does not wait for it.
+    if (shard.journal) {
+      shard.journal->append(std::span<const Instruction>(batch, n));
+      shard.journalOverflows.store(shard.journal->overflowedBatches(), std::memory_order_relaxed);
+    }
+    matchingEngine.processBatch(std::span<const Instruction>(batch, n), std::span<InstructionResult>(results, n));
+    for (size_t i = 0; i < n; ++i) {
+      accepted += results[i].accepted;
+    }
+    processed += n;
+
+    shard.processed.store(processed, std::memory_order_relaxed);
+    shard.accepted.store(accepted, std::memory_order_relaxed);
+    shard.queueLatencyNsTotal.store(latencyTotal, std::memory_order_relaxed);
+    shard.queueLatencyNsMax.store(latencyMax, std::memory_order_relaxed);
+  }
+}
@@ -0,0 +1,128 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include "../include/SlabArena.h"
+
+#include <cstdint>
+#include <new>
+#include <sys/mman.h>
+
+namespace {
+
+constexpr size_t hugePageSize = size_t{2} << 20;
+constexpr size_t regionBytes = sizeof(SlabArena::Slab) * Config::slabArenaRegionSlabs;
+
+size_t mappingLength(size_t bytes) {
+  return (bytes + hugePageSize - 1) & ~(hugePageSize - 1);
+}
+
+// Explicit huge pages when some are reserved (vm.nr_hugepages), otherwise a
+// regular mapping aligned to a huge page boundary with a transparent huge
+// page hint, so the kernel can still back it with 2MB pages. hugetlb tells
+// which of the two it is.
+void* mapHuge(size_t bytes, bool& hugetlb) {
+  const size_t length = mappingLength(bytes);
+  hugetlb = false;
+#ifdef MAP_HUGETLB
+  void* huge = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (huge != MAP_FAILED) {
+    hugetlb = true;
+    return huge;
+  }
+#endif
+
+  void* raw = mmap(nullptr, length + hugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (raw == MAP_FAILED) throw std::bad_alloc();
+  uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+  uintptr_t aligned = (start + hugePageSize - 1) & ~(hugePageSize - 1);
+  if (aligned > start) munmap(raw, aligned - start); // Trim to the aligned range
+  munmap(reinterpret_cast<void*>(aligned + length), start + hugePageSize - aligned);
+  void* const region = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+  madvise(region, length, MADV_HUGEPAGE);
+#endif
+  return region;
+}
+
+} // namespace
+
+SlabArena::~SlabArena() {
+  for (const Region& region : regions) {
+    munmap(region.base, mappingLength(regionBytes));
+  }
+}
+
+SlabArena& SlabArena::shared() {
+  static SlabArena arena;
+  return arena;
+}
+
+void SlabArena::mapRegion() {
+  Region region;
+  region.base = mapHuge(regionBytes, region.hugetlb);
+  regions.push_back(region);
+  carved = 0;
+}
+
+SlabArena::Slab* SlabArena::acquire() {
+  std::lock_guard<std::mutex> lock(mutex);
+  Slab* slab;
+  if (!warm.empty()) {
+    slab = warm.back();
+    warm.pop_back();
+  } else if (!cold.empty()) {
+    slab = cold.back();
+    cold.pop_back();
+  } else {
+    if (regions.empty() || carved == Config::slabArenaRegionSlabs) mapRegion();
+    slab = static_cast<Slab*>(regions.back().base) + carved++;
+  }
+  inUse++;
+  return slab;
+}
+
+void SlabArena::release(Slab* slab) {
+  std::lock_guard<std::mutex> lock(mutex);
+  inUse--;
+  if (warm.size() < Config::slabArenaWarmSlabs) {
+    warm.push_back(slab);
+    return;
+  }
+  // Past a burst: keep the address range, give the pages back. A
+  // transparent huge page under the slab is split by the kernel, but
+  // MAP_HUGETLB pages cannot be given back a slab at a time, so those slabs
+  // stay warm, as does any slab the kernel refuses to drop.
+  if (inHugetlbRegion(slab) || madvise(slab, sizeof(Slab), MADV_DONTNEED) != 0) {
+    warm.push_back(slab);
+    return;
+  }
+  cold.push_back(slab);
+}
+
+bool SlabArena::inHugetlbRegion(const Slab* slab) const {
+  const char* address = reinterpret_cast<const char*>(slab);
+  for (const Region& region : regions) {
+    const char* base = static_cast<const char*>(region.base);
+    if (address >= base && address < base + regionBytes) return region.hugetlb;
+  }
+  return false;
+}
+
+size_t SlabArena::slabsInUse() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return inUse;
+}
+
+size_t SlabArena::residentBytes() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return (inUse + warm.size()) * sizeof(Slab);
+}
+
+size_t SlabArena::mappedBytes() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return regions.size() * mappingLength(regionBytes);
+}
@@ -0,0 +1,245 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+
+#include "../include/WorkloadGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Recently cancelled orders each flow remembers for stale instructions.
+constexpr size_t goneCapacity = 1024;
+
+// Derives independent seeds from the model's seed.
+uint64_t splitmix64(uint64_t x) {
+  x += 0x9e3779b97f4a7c15;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+  return x ^ (x >> 31);
+}
+
+// [0, 1) from the top 53 bits.
+double uniform(std::mt19937_64& rng) {
+  return static_cast<double>(rng() >> 11) * 0x1.0p-53;
+}
+
+double exponential(std::mt19937_64& rng, double mean) {
+  return -mean * std::log1p(-uniform(rng));
+}
+
+bool chance(std::mt19937_64& rng, double probability) {
+  return uniform(rng) < probability;
+}
+
+uint32_t toTicks(double price) {
+  return static_cast<uint32_t>(std::llround(price * Config::ticksPerUnit));
+}
+
+// Orders the live heap by earliest cancelDue first.
+constexpr auto expiresLater = [](const auto& a, const auto& b) { return a.cancelDue > b.cancelDue; };
+
+} // namespace
+
+WorkloadGenerator::WorkloadGenerator(const WorkloadModel& model)
+    : model(model),
+      pickRng(splitmix64(model.seed ^ 0x7069636b)),
+      minMid(std::max<uint32_t>(toTicks(model.minMidPrice), model.maxPassiveOffset + 1)),
+      maxMid(std::max(minMid, toTicks(model.maxMidPrice))) {
+  flows.reserve(model.tickerCount);
+  for (size_t t = 0; t < model.tickerCount; ++t) {
+    flows.push_back(makeFlow(static_cast<uint16_t>(t)));
+    shares.push_back(1.0 / std::pow(static_cast<double>(t + 1), model.tickerZipfExponent));
+  }
+  cumulative.resize(flows.size());
+}
+
+WorkloadGenerator::WorkloadGenerator(const WorkloadModel& model, uint16_t tickerId)
+    : model(model),
+      pickRng(splitmix64(model.seed ^ 0x7069636b ^ (uint64_t{tickerId} << 32))),
+      minMid(std::max<uint32_t>(toTicks(model.minMidPrice), model.maxPassiveOffset + 1)),
+      maxMid(std::max(minMid, toTicks(model.maxMidPrice))) {
+  flows.push_back(makeFlow(tickerId));
+  shares.push_back(1.0);
+  cumulative.resize(1);
+}
+
+WorkloadGenerator::TickerFlow WorkloadGenerator::makeFlow(uint16_t tickerId) const {
+  TickerFlow flow;
+  flow.rng.seed(splitmix64(model.seed + tickerId));
+  flow.tickerId = tickerId;
+  flow.mid = minMid + static_cast<uint32_t>(uniform(flow.rng) * (maxMid - minMid));
+  flow.gone.reserve(goneCapacity);
+  return flow;
+}
+
+// A flow drawn by its share, bursting ones burstIntensity times as likely.
+// The running sums are only rebuilt when a burst starts or ends.
+size_t WorkloadGenerator::pickFlow() {
+  if (flows.size() == 1) return 0;
+  if (weightsChanged) {
+    double sum = 0.0;
+    for (size_t i = 0; i < flows.size(); ++i) {
+      sum += shares[i] * (flows[i].burstLeft > 0 ? model.burstIntensity : 1.0);
+      cumulative[i] = sum;
+    }
+    weightsChanged = false;
+  }
+  const double target = uniform(pickRng) * cumulative.back();
+  const size_t i = std::upper_bound(cumulative.begin(), cumulative.end(), target) - cumulative.begin();
+  return std::min(i, flows.size() - 1);
+}
+
+Instruction WorkloadGenerator::next() {
+  TickerFlow& flow = flows[pickFlow()];
+  const bool bursting = flow.burstLeft > 0;
+  elapsed += exponential(pickRng, model.meanArrivalGap / (bursting ? model.burstIntensity : 1.0));
+  Instruction out = nextOf(flow);
+  out.timestamp = Config::initialTimestamp + static_cast<uint64_t>(elapsed);
+  return out;
+}
+
+void WorkloadGenerator::generate(size_t count, std::vector<Instruction>& out) {
+  out.reserve(out.size() + count);
+  for (size_t i = 0; i < count; ++i) {
+    out.push_back(next());
+  }
+}
+
+std::vector<Instruction> WorkloadGenerator::generate(const WorkloadModel& model, size_t count) {
+  std::vector<Instruction> out;
+  WorkloadGenerator(model).generate(count, out);
+  return out;
+}
+
+std::vector<size_t> WorkloadGenerator::tickerShares(const WorkloadModel& model, size_t total) {
+  std::vector<double> weights(model.tickerCount);
+  double sum = 0.0;
+  for (size_t t = 0; t < weights.size(); ++t) {
+    weights[t] = 1.0 / std::pow(static_cast<double>(t + 1), model.tickerZipfExponent);
+    sum += weights[t];
+  }
+  std::vector<size_t> counts(weights.size());
+  size_t assigned = 0;
+  for (size_t t = 0; t < weights.size(); ++t) {
+    counts[t] = static_cast<size_t>(static_cast<double>(total) * weights[t] / sum);
+    assigned += counts[t];
+  }
+  for (size_t t = 0; assigned < total; t = (t + 1) % counts.size(), ++assigned) {
+    counts[t]++; // Rounding leftovers, busiest first
+  }
+  return counts;
+}
+
+void WorkloadGenerator::advanceBurst(TickerFlow& flow) {
+  if (flow.burstLeft > 0) {
+    if (--flow.burstLeft == 0) weightsChanged = true;
+  } else if (chance(flow.rng, model.burstStartProbability)) {
+    flow.burstLeft = 1 + static_cast<uint64_t>(exponential(flow.rng, model.burstLengthMean));
+    weightsChanged = true;
+  }
+}
+
+Instruction WorkloadGenerator::nextOf(TickerFlow& flow) {
+  flow.generated++;
+  advanceBurst(flow);
+  const bool bursting = flow.burstLeft > 0;
+
+  if (chance(flow.rng, model.midStepProbability * (bursting ? model.burstIntensity : 1.0))) {
+    if (flow.rng() & 1) {
+      flow.mid = std::min(flow.mid + 1, maxMid);
+    } else {
+      flow.mid = std::max(flow.mid - 1, minMid);
+    }
+  }
+
+  Instruction out{};
+  out.tickerId = flow.tickerId;
+  // Cancels come from the lifetimes alone; the mix only splits the rest.
+  if (!flow.live.empty() && flow.live.front().cancelDue <= flow.generated) {
+    cancelOrder(flow, out);
+    return out;
+  }
+  const int roll = static_cast<int>(uniform(flow.rng) * (model.addWeight + model.editWeight));
+  if (flow.live.empty() || roll < model.addWeight) {
+    addOrder(flow, out);
+  } else {
+    editOrder(flow, out);
+  }
+  return out;
+}
+
+void WorkloadGenerator::addOrder(TickerFlow& flow, Instruction& out) {
+  const bool isBuy = flow.rng() >> 63;
+  const double marketable = (flow.burstLeft > 0) ? model.burstMarketableRatio : model.marketableRatio;
+  out.ID = flow.nextId++;
+  out.action = InstructionAction::Add;
+  out.flags = Instruction::makeFlags(isBuy);
+  out.quantity = quantity(flow);
+
+  if (chance(flow.rng, marketable)) {
+    const uint32_t through = 1 + std::min<uint32_t>(static_cast<uint32_t>(exponential(flow.rng, model.marketableOffsetMean)),
+                                                    model.maxPassiveOffset - 1);
+    out.price = isBuy ? flow.mid + through : flow.mid - std::min(through, flow.mid - 1);
+    return;
+  }
+  out.price = passivePrice(flow, isBuy);
+
+  const double lifetimeMean = chance(flow.rng, model.fastCancelShare) ? model.fastCancelMean : model.slowCancelMean;
+  const uint64_t lifetime = 1 + static_cast<uint64_t>(exponential(flow.rng, lifetimeMean));
+  flow.live.push_back({flow.generated + lifetime, out.ID, isBuy});
+  std::push_heap(flow.live.begin(), flow.live.end(), expiresLater);
+}
+
+// The cancel of the live order due first (or of a gone one, when stale; the
+// due order then goes out with the next instruction).
+void WorkloadGenerator::cancelOrder(TickerFlow& flow, Instruction& out) {
+  LiveOrder order;
+  if (drawStale(flow)) {
+    order = flow.gone[flow.rng() % flow.gone.size()];
+  } else {
+    std::pop_heap(flow.live.begin(), flow.live.end(), expiresLater);
+    order = flow.live.back();
+    flow.live.pop_back();
+    if (flow.gone.size() < goneCapacity) {
+      flow.gone.push_back(order);
+    } else {
+      flow.gone[flow.goneNext++ % goneCapacity] = order;
+    }
+  }
+  out.ID = order.ID;
+  out.action = InstructionAction::Cancel;
+  out.flags = Instruction::makeFlags(order.isBuy);
+}
+
+// A new passive price and quantity for a live order (or a gone one, when
+// stale); its cancel stays due when it was.
+void WorkloadGenerator::editOrder(TickerFlow& flow, Instruction& out) {
+  const LiveOrder& order = drawStale(flow) ? flow.gone[flow.rng() % flow.gone.size()]
+                                           : flow.live[flow.rng() % flow.live.size()];
+  out.ID = order.ID;
+  out.action = InstructionAction::Edit;
+  out.flags = Instruction::makeFlags(order.isBuy);
+  out.price = passivePrice(flow, order.isBuy);
+  out.quantity = quantity(flow);
+}
+
+uint32_t WorkloadGenerator::passivePrice(TickerFlow& flow, bool isBuy) {
+  const uint32_t offset = 1 + std::min<uint32_t>(static_cast<uint32_t>(exponential(flow.rng, model.passiveOffsetMean)),
+                                                 model.maxPassiveOffset - 1);
+  return isBuy ? flow.mid - offset : flow.mid + offset;
+}
+
+uint32_t WorkloadGenerator::quantity(TickerFlow& flow) {
+  const double pareto = Config::minGenQty / std::pow(1.0 - uniform(flow.rng), 1.0 / model.quantityTailIndex);
+  return 10 * static_cast<uint32_t>(std::min<double>(pareto, Config::maxGenQty));
+}
+
+bool WorkloadGenerator::drawStale(TickerFlow& flow) {
+  return model.staleProbability > 0.0 && !flow.gone.empty() && chance(flow.rng, model.staleProbability);
+}
@@ -0,0 +1,58 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
+
+#include "../include/MatchingEngine.h"
+
+namespace {
+
+void expectSameDepth(const MatchingEngine& a, const MatchingEngine& b, uint32_t tickerId, bool isBuy) {
+    DepthLevel left[16];
+    DepthLevel right[16];
+    const size_t n = a.getDepth(tickerId, isBuy, 16, left);
+    ASSERT_EQ(b.getDepth(tickerId, isBuy, 16, right), n);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_EQ(left[i].price, right[i].price);
+        EXPECT_EQ(left[i].quantity, right[i].quantity);
+        EXPECT_EQ(left[i].orderCount, right[i].orderCount);
+    }
+}
+
+} // namespace
+
+// A book that has seen every kind of amend writes a snapshot it can load.
+TEST(BookSnapshotTest, RoundTripAfterAmends) {
+    MatchingEngine live(2);
+    for (uint32_t id = 1; id <= 6; ++id) {
+        live.processOrders(0, id % 2 == 0, id % 2 == 0 ? 990 - id : 1010 + id, 100, id, id);
+    }
+    live.processOrders(1, true, 500, 40, 7, 7);
+    live.processOrders(1, true, 500, 60, 8, 8);
+
+    EXPECT_TRUE(live.editOrder(0, 2, 988, 30));  // Quantity down, same price
+    EXPECT_TRUE(live.editOrder(0, 3, 1013, 0));  // To 0, same price
+    EXPECT_TRUE(live.editOrder(0, 4, 980, 100)); // New price
+    EXPECT_TRUE(live.editOrder(1, 7, 500, 0));   // To 0, ahead of another order
+
+    const std::string path = testing::TempDir() + "BookSnapshotTest.snap";
+    ASSERT_TRUE(live.writeSnapshot(path));
+    MatchingEngine restored(0);
+    ASSERT_TRUE(restored.restoreSnapshot(path));
+    std::remove(path.c_str());
+
+    ASSERT_EQ(restored.bookCount(), 2u);
+    for (uint32_t tickerId = 0; tickerId < 2; ++tickerId) {
+        expectSameDepth(live, restored, tickerId, true);
+        expectSameDepth(live, restored, tickerId, false);
+    }
+    EXPECT_FALSE(restored.cancelOrder(0, 3));
+    EXPECT_FALSE(restored.cancelOrder(1, 7));
+    EXPECT_TRUE(restored.cancelOrder(1, 8));
+}
@@ -0,0 +1,46 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include "../include/InstructionParser.h"
+#include "../include/Price.h"
+
+TEST(InstructionParserTest, OutOfRangePriceIsInvalidNotWrapped) {
+    const std::string line = "1;AAPL;B;50000000.00;10;A;5\n";
+    const char* p = line.data();
+    Instruction out;
+    ASSERT_TRUE(parseInstructionLine(p, line.data() + line.size(), 0, out));
+    EXPECT_EQ(out.price, invalidPriceTicks);
+
+    const std::string huge = "1;AAPL;B;99999999999999999999999.5;10;A;5\n";
+    p = huge.data();
+    ASSERT_TRUE(parseInstructionLine(p, huge.data() + huge.size(), 0, out));
+    EXPECT_EQ(out.price, invalidPriceTicks);
+}
+
+// The block decoder takes prices of up to eight characters; the rest fall
+// back to parseInstructionLine. Both have to agree on what is out of range.
+TEST(InstructionParserTest, BlockDecoderRejectsOutOfRangePrices) {
+    std::string text = "1;AAPL;B;123.45;10;A;5\n"
+                       "2;AAPL;S;1677722;10;A;6\n"
+                       "3;AAPL;B;1677721;10;A;7\n"
+                       "4;AAPL;B;50000000.00;10;A;8\n";
+    for (int i = 0; i < 8; ++i) text += "5;AAPL;S;1.0;1;A;9\n";
+    const ParserIsa isas[] = {ParserIsa::Scalar, detectParserIsa()};
+    for (ParserIsa isa : isas) {
+        const char* p = text.data();
+        Instruction out[16];
+        size_t skipped = 0;
+        ASSERT_EQ(parseInstructions(isa, p, text.data() + text.size(), 0, out, 16, skipped), 12u);
+        EXPECT_EQ(out[0].price, 1235u) << parserIsaName(isa);
+        EXPECT_EQ(out[1].price, invalidPriceTicks) << parserIsaName(isa);
+        EXPECT_EQ(out[2].price, 16777210u) << parserIsaName(isa);
+        EXPECT_EQ(out[3].price, invalidPriceTicks) << parserIsaName(isa);
+    }
+}
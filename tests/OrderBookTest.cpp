@@ -0,0 +1,44 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <gtest/gtest.h>
+
+#include "../include/OrderBook.h"
+
+// An amend to quantity 0 at the same price takes the order out of the book
+// like a cancel, rather than leaving an empty order in the queue.
+TEST(OrderBookTest, EditToZeroAtSamePriceRemovesOrder) {
+    OrderBook book;
+    book.processOrders(true, 1000, 100, 0, 1);
+    book.processOrders(true, 1000, 50, 0, 2);
+
+    EXPECT_TRUE(book.editOrder(1, 1000, 0));
+
+    DepthLevel depth[2];
+    ASSERT_EQ(book.getDepth(true, 2, depth), 1u);
+    EXPECT_EQ(depth[0].quantity, 50u);
+    EXPECT_EQ(depth[0].orderCount, 1u);
+    EXPECT_FALSE(book.cancelOrder(1));
+
+    // The sell meets order 2 only: one fill, no zero-quantity one first.
+    const ExecutionSummary summary = book.processOrders(false, 1000, 50, 0, 3);
+    EXPECT_EQ(summary.filledQuantity, 50u);
+    EXPECT_EQ(summary.fills, 1u);
+    EXPECT_EQ(book.getDepth(true, 2, depth), 0u);
+}
+
+TEST(OrderBookTest, EditToZeroEmptiesLevel) {
+    OrderBook book;
+    book.processOrders(false, 1200, 10, 0, 1);
+
+    EXPECT_TRUE(book.editOrder(1, 1200, 0));
+
+    DepthLevel depth[1];
+    EXPECT_EQ(book.getDepth(false, 1, depth), 0u);
+    book.publishMarketData();
+    EXPECT_EQ(book.getBBO().askPrice, 0u);
+}
@@ -0,0 +1,106 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/Configuration.h"
+#include "../include/InstructionParser.h"
+#include "../include/InstructionFile.h"
+
+// Converts one ticker's text file (<TICKER>.dat) into the binary format
+// (<TICKER>.bin). Lines with an unknown instruction type are dropped.
+// Returns the number of records written.
+uint64_t convert_ticker(uint32_t tickerId) {
+    const std::string input = Config::tickers[tickerId] + Config::textDataExtension;
+    const std::string output = Config::tickers[tickerId] + Config::binaryDataExtension;
+
+    int fd = open(input.c_str(), O_RDONLY);
+    if (fd == -1) {
+        std::cerr << "Cannot open " << input << std::endl;
+        return 0;
+    }
+    struct stat sb;
+    if (fstat(fd, &sb) == -1 || sb.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+    size_t file_size = sb.st_size;
+    const char* mapped_file = static_cast<const char*>(mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0));
+    close(fd);
+    if (mapped_file == MAP_FAILED) {
+        std::cerr << "Cannot map " << input << std::endl;
+        return 0;
+    }
+    madvise((void*)mapped_file, file_size, MADV_SEQUENTIAL);
+
+    std::ofstream outfile(output, std::ios::binary);
+    if (!outfile) {
+        std::cerr << "Error opening file for writing: " << output << std::endl;
+        munmap((void*)mapped_file, file_size);
+        return 0;
+    }
+    writeInstructionFileHeader(outfile, 0); // Count is patched in at the end
+
+    std::vector<Instruction> buffer;
+    buffer.reserve(1 << 20);
+    uint64_t count = 0;
+
+    const char* p = mapped_file;
+    const char* end = mapped_file + file_size;
+    while (p < end) {
+        Instruction record;
+        if (!parseInstructionLine(p, end, static_cast<uint16_t>(tickerId), record)) continue;
+        buffer.push_back(record);
+        if (buffer.size() == buffer.capacity()) {
+            outfile.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(Instruction));
+            count += buffer.size();
+            buffer.clear();
+        }
+    }
+    outfile.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(Instruction));
+    count += buffer.size();
+
+    outfile.seekp(0);
+    writeInstructionFileHeader(outfile, count);
+    munmap((void*)mapped_file, file_size);
+    return count;
+}
+
+// Usage: convert_data
+// Converts the text file of every ticker in Config::tickers, one thread each.
+int main() {
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::vector<std::thread> threads;
+    std::vector<uint64_t> counts(Config::tickers.size());
+    for (uint32_t i = 0; i < Config::tickers.size(); ++i) {
+        threads.emplace_back([i, &counts] { counts[i] = convert_ticker(i); });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < Config::tickers.size(); ++i) {
+        std::cout << Config::tickers[i] << ": " << counts[i] << " records" << std::endl;
+        total += counts[i];
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+    std::cout << "Converted " << total << " instructions to " << Config::binaryDataExtension << " files in " << duration_ms << " ms." << std::endl;
+    return 0;
+}
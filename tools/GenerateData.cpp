@@ -9,102 +9,62 @@
 #include <fstream>
 #include <vector>
 #include <string>
-#include <algorithm>
-#include <random>
-#include <iomanip>
 #include <thread>
 #include <atomic>
 #include <chrono>
-#include <filesystem>
+#include <cstdio>
 
 #include "../include/Configuration.h"
+#include "../include/InstructionFile.h"
+#include "../include/WorkloadGenerator.h"
+
+// Writes one instruction in the text format of InstructionParser.h. Prices
+// are printed with two decimals, which holds any tick of a grid of up to 100
+// ticks per unit exactly.
+static_assert(Config::ticksPerUnit <= 100, "Text prices carry two decimals");
+static int format_instruction(const Instruction& record, const std::string& ticker, char* line, size_t size) {
+    char type = 'A';
+    if (record.action == InstructionAction::Cancel) type = 'C';
+    if (record.action == InstructionAction::Edit) type = 'E';
+    return snprintf(line, size, "%u;%s;%c;%.2f;%u;%c;%lu\n",
+                    record.ID, ticker.c_str(), record.isBuy() ? 'B' : 'S',
+                    static_cast<double>(record.price) / Config::ticksPerUnit, record.quantity, type,
+                    static_cast<unsigned long>(record.timestamp));
+}
 
-// The producer thread: generates instructions for a single ticker and writes to its own file.
-void generator_thread_func(int thread_id, int num_instructions, uint32_t initial_id, uint64_t initial_timestamp, std::atomic<int>& progress_counter) {
-    struct ActiveOrderRecord {
-        uint32_t id;
-        char side;
-    };
-
-    uint32_t tickerId = thread_id;
-    std::string filename = Config::tickers[tickerId] + ".dat";
+// The producer thread: generates the flow of a single ticker under the model
+// and writes it to its own file. Binary records are the instructions exactly
+// as the text replay decodes the text lines, so both files replay identically.
+void generator_thread_func(int thread_id, size_t num_instructions, const WorkloadModel& model, bool binary, std::atomic<int>& progress_counter) {
+    uint16_t tickerId = static_cast<uint16_t>(thread_id);
+    std::string filename = Config::tickers[tickerId] + (binary ? Config::binaryDataExtension : Config::textDataExtension);
     std::ofstream outfile(filename, std::ios::binary);
     if (!outfile) {
         std::cerr << "Error opening file for writing: " << filename << std::endl;
         return;
     }
+    if (binary) {
+        writeInstructionFileHeader(outfile, num_instructions);
+    }
 
-    std::vector<ActiveOrderRecord> active_orders;
-    active_orders.reserve(num_instructions * 0.6);
-    std::vector<ActiveOrderRecord> inactive_orders;
-    inactive_orders.reserve(num_instructions * 0.3);
-
-    std::mt19937 rng(std::chrono::high_resolution_clock::now().time_since_epoch().count() + thread_id);
-    std::uniform_int_distribution<int> qty_dist(Config::minGenQty, Config::maxGenQty);
-    std::uniform_real_distribution<double> price_dist(Config::minGenPrice, Config::maxGenPrice);
-    std::uniform_int_distribution<int> instruction_type_dist(1, 100);
-    std::uniform_real_distribution<double> stale_dist(0.0, 1.0);
+    WorkloadGenerator generator(model, tickerId);
 
-    uint32_t id_counter = initial_id;
-    
     std::vector<char> buffer;
     buffer.reserve(16 * 1024 * 1024); // 16MB buffer
 
-    const int progress_step = num_instructions / 10;
-
-    for (int i = 0; i < num_instructions; ++i) {
-        char line[256];
-        int len = 0;
-
-        int instruction_type_roll = instruction_type_dist(rng);
-        bool force_add = active_orders.empty();
-
-        uint64_t timestamp = initial_timestamp + i;
-
-        if (!force_add && instruction_type_roll <= Config::cancelInstructionWeight) { // CANCEL
-            bool generate_stale = Config::staleInstruction && !inactive_orders.empty() && stale_dist(rng) < Config::staleInstructionProbability;
-            ActiveOrderRecord record_to_modify;
-
-            if (generate_stale) {
-                std::uniform_int_distribution<int> inactive_order_dist(0, inactive_orders.size() - 1);
-                record_to_modify = inactive_orders[inactive_order_dist(rng)];
-            } else {
-                std::uniform_int_distribution<int> active_order_dist(0, active_orders.size() - 1);
-                int order_idx = active_order_dist(rng);
-                record_to_modify = active_orders[order_idx];
-                inactive_orders.push_back(active_orders[order_idx]);
-                std::swap(active_orders[order_idx], active_orders.back());
-                active_orders.pop_back();
-            }
-            len = snprintf(line, sizeof(line), "%u;%s;%c;0.00;0;C;%lu\n",
-                           record_to_modify.id, Config::tickers[tickerId].c_str(),
-                           record_to_modify.side, timestamp);
-
-        } else if (!force_add && instruction_type_roll <= (Config::cancelInstructionWeight + Config::editInstructionWeight)) { // EDIT
-            bool generate_stale = Config::staleInstruction && !inactive_orders.empty() && stale_dist(rng) < Config::staleInstructionProbability;
-            ActiveOrderRecord record_to_modify;
-
-            if (generate_stale) {
-                std::uniform_int_distribution<int> inactive_order_dist(0, inactive_orders.size() - 1);
-                record_to_modify = inactive_orders[inactive_order_dist(rng)];
-            } else {
-                std::uniform_int_distribution<int> active_order_dist(0, active_orders.size() - 1);
-                record_to_modify = active_orders[active_order_dist(rng)];
-            }
-            len = snprintf(line, sizeof(line), "%u;%s;%c;%.2f;%u;E;%lu\n",
-                           record_to_modify.id, Config::tickers[tickerId].c_str(),
-                           record_to_modify.side, price_dist(rng), qty_dist(rng) * 10, timestamp);
-
-        } else { // ADD
-            char side = (rng() % 2 == 0) ? 'B' : 'S';
-            len = snprintf(line, sizeof(line), "%u;%s;%c;%.2f;%u;A;%lu\n",
-                           id_counter, Config::tickers[tickerId].c_str(),
-                           side, price_dist(rng), qty_dist(rng) * 10, timestamp);
-            active_orders.push_back({id_counter, side});
-            id_counter++;
+    const size_t progress_step = num_instructions / 10;
+
+    for (size_t i = 0; i < num_instructions; ++i) {
+        Instruction record = generator.next();
+
+        if (binary) {
+            const char* bytes = reinterpret_cast<const char*>(&record);
+            buffer.insert(buffer.end(), bytes, bytes + sizeof(record));
+        } else {
+            char line[256];
+            int len = format_instruction(record, Config::tickers[tickerId], line, sizeof(line));
+            buffer.insert(buffer.end(), line, line + len);
         }
-        
-        buffer.insert(buffer.end(), line, line + len);
 
         if (buffer.size() >= 16 * 1024 * 1024) {
             outfile.write(buffer.data(), buffer.size());
@@ -121,18 +81,33 @@ void generator_thread_func(int thread_id, int num_instructions, uint32_t initial
     }
 }
 
+// Usage: generate_data [--binary] [--seed N]
+// The same seed writes the same files on every run; the default is
+// Config::workloadSeed.
 int main(int argc, char* argv[]) {
+    bool binary = false;
+    WorkloadModel model;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--binary") {
+            binary = true;
+        } else if (arg == "--seed" && i + 1 < argc) {
+            model.seed = std::stoull(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--binary] [--seed N]" << std::endl;
+            return 1;
+        }
+    }
     auto start_time = std::chrono::high_resolution_clock::now();
 
     unsigned int num_threads = Config::tickers.size();
     std::vector<std::thread> threads;
-    int instructions_per_ticker = Config::numInstructions / num_threads;
+    // Busier tickers get more instructions, by the model's Zipf shares
+    std::vector<size_t> instructions_per_ticker = WorkloadGenerator::tickerShares(model, Config::numInstructions);
     std::atomic<int> progress_counter(0);
 
     for (unsigned int i = 0; i < num_threads; ++i) {
-        uint32_t initial_id = Config::initialOrderId + (i * instructions_per_ticker * 2);
-        uint64_t initial_timestamp = Config::initialTimestamp;
-        threads.emplace_back(generator_thread_func, i, instructions_per_ticker, initial_id, initial_timestamp, std::ref(progress_counter));
+        threads.emplace_back(generator_thread_func, i, instructions_per_ticker[i], std::cref(model), binary, std::ref(progress_counter));
     }
 
     // Progress reporting
@@ -152,7 +127,7 @@ int main(int argc, char* argv[]) {
     auto end_time = std::chrono::high_resolution_clock::now();
     auto duration_s = std::chrono::duration_cast<std::chrono::seconds>(end_time - start_time).count();
 
-    std::cout << "Generated " << Config::numInstructions << " instructions into per-ticker files in " << duration_s << " seconds." << std::endl;
+    std::cout << "Generated " << Config::numInstructions << " instructions into per-ticker files in " << duration_s << " seconds (seed " << model.seed << ")." << std::endl;
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,173 @@
+// ----------------------------------------------------------------------------- //
+//                                                                               //
+//  Order Book Simulator                                                         //
+//  Copyright (c) 2025 Flavio Milinanni. All Rights Reserved.                    //
+//                                                                               //
+// ----------------------------------------------------------------------------- //
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/Configuration.h"
+#include "../include/InputJournal.h"
+#include "../include/MatchingEngine.h"
+
+struct MappedJournal {
+    std::string path;
+    void* mapping = MAP_FAILED;
+    size_t size = 0;
+    const JournalRecord* records = nullptr;
+    size_t count = 0;   // Intact records, the ones replayed
+    size_t ignored = 0; // Records after them, torn or never written
+    uint64_t accepted = 0;
+};
+
+// Maps a journal and finds its intact records. Returns false if it cannot
+// be read or was not written by this build.
+bool map_journal(MappedJournal& journal) {
+    int fd = open(journal.path.c_str(), O_RDONLY);
+    if (fd == -1) return false;
+    struct stat sb;
+    if (fstat(fd, &sb) == -1 || static_cast<size_t>(sb.st_size) < sizeof(JournalFileHeader)) {
+        close(fd);
+        return false;
+    }
+    journal.size = sb.st_size;
+    journal.mapping = mmap(NULL, journal.size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (journal.mapping == MAP_FAILED) return false;
+    madvise(journal.mapping, journal.size, MADV_SEQUENTIAL);
+
+    const char* file = static_cast<const char*>(journal.mapping);
+    JournalFileHeader header;
+    std::memcpy(&header, file, sizeof(header));
+    if (!isValidJournalFile(header, journal.size)) return false;
+    const size_t available = (journal.size - sizeof(header)) / sizeof(JournalRecord);
+    journal.records = reinterpret_cast<const JournalRecord*>(file + sizeof(header));
+    journal.count = journalRecordCount(journal.records, available);
+    journal.ignored = available - journal.count;
+    return true;
+}
+
+// Runs a journal's records through the engine in batches of batch_size, in
+// journal order.
+void replay_journal(MatchingEngine& engine, MappedJournal& journal, size_t batch_size) {
+    Instruction batch[Config::maxInstructionBatchSize];
+    InstructionResult results[Config::maxInstructionBatchSize];
+    for (size_t i = 0; i < journal.count; i += batch_size) {
+        const size_t n = std::min(batch_size, journal.count - i);
+        for (size_t j = 0; j < n; ++j) {
+            batch[j] = journal.records[i + j].instruction;
+        }
+        engine.processBatch(std::span<const Instruction>(batch, n), std::span<InstructionResult>(results, n));
+        for (size_t j = 0; j < n; ++j) {
+            journal.accepted += results[j].accepted;
+        }
+    }
+}
+
+// Usage: replay_journal [--snapshot FILE] [--batch N] JOURNAL...
+// Rebuilds the books from the journals of a ShardedEngine (shard-<i>.journal),
+// replaying each journal on a thread of its own, and optionally snapshots
+// the result (see BookSnapshot.h). Records after a torn or missing one are
+// ignored and counted. --batch sets the processBatch depth, by default
+// Config::instructionBatchSize.
+int main(int argc, char* argv[]) {
+    std::string snapshot_path;
+    size_t batch_size = Config::instructionBatchSize;
+    std::vector<MappedJournal> journals;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--snapshot" && i + 1 < argc) {
+            snapshot_path = argv[++i];
+        } else if (arg == "--batch" && i + 1 < argc) {
+            const long long value = std::atoll(argv[++i]);
+            if (value < 1 || static_cast<size_t>(value) > Config::maxInstructionBatchSize) {
+                std::cerr << "--batch must be between 1 and " << Config::maxInstructionBatchSize << std::endl;
+                return 1;
+            }
+            batch_size = static_cast<size_t>(value);
+        } else {
+            journals.push_back({});
+            journals.back().path = arg;
+        }
+    }
+    if (journals.empty()) {
+        std::cerr << "Usage: " << argv[0] << " [--snapshot FILE] [--batch N] JOURNAL..." << std::endl;
+        return 1;
+    }
+
+    int status = 0;
+    for (auto& journal : journals) {
+        if (!map_journal(journal)) {
+            std::cerr << "Cannot replay " << journal.path << std::endl;
+            status = 1;
+        }
+    }
+
+    // Journals are replayed in parallel, so no two may share a book, as the
+    // shards of one engine never do.
+    std::vector<int> owner;
+    for (size_t j = 0; status == 0 && j < journals.size(); ++j) {
+        for (size_t i = 0; i < journals[j].count; ++i) {
+            const uint16_t tickerId = journals[j].records[i].instruction.tickerId;
+            if (tickerId >= owner.size()) owner.resize(tickerId + 1, -1);
+            if (owner[tickerId] == -1) owner[tickerId] = static_cast<int>(j);
+            if (owner[tickerId] != static_cast<int>(j)) {
+                std::cerr << journals[owner[tickerId]].path << " and " << journals[j].path << " both hold ticker " << tickerId << std::endl;
+                status = 1;
+                break;
+            }
+        }
+    }
+
+    if (status == 0) {
+        auto engine = std::make_unique<MatchingEngine>(owner.size());
+        auto start_time = std::chrono::high_resolution_clock::now();
+        std::vector<std::thread> threads;
+        for (auto& journal : journals) {
+            threads.emplace_back(replay_journal, std::ref(*engine), std::ref(journal), batch_size);
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+
+        uint64_t total = 0;
+        for (const auto& journal : journals) {
+            std::cout << journal.path << ": " << journal.count << " records replayed, " << journal.accepted << " accepted";
+            if (journal.ignored > 0) std::cout << ", " << journal.ignored << " ignored after a torn record";
+            std::cout << std::endl;
+            total += journal.count;
+        }
+        const double seconds = std::max<double>(duration_ms, 1) / 1000.0;
+        std::cout << "Replayed " << total << " instructions in " << duration_ms << " ms ("
+                  << total / seconds / 1e6 << " M/s)." << std::endl;
+
+        if (!snapshot_path.empty()) {
+            if (engine->writeSnapshot(snapshot_path)) {
+                std::cout << "Wrote snapshot " << snapshot_path << std::endl;
+            } else {
+                std::cerr << "Cannot write snapshot " << snapshot_path << std::endl;
+                status = 1;
+            }
+        }
+    }
+
+    for (auto& journal : journals) {
+        if (journal.mapping != MAP_FAILED) munmap(journal.mapping, journal.size);
+    }
+    return status;
+}